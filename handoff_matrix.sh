@@ -0,0 +1,69 @@
+#!/bin/sh
+# SPDX-License-Identifier: MIT
+#
+# Builds the DFU hand-off across compilers and optimisation levels, checks
+# that nothing touches the stack once the main stack pointer has switched,
+# and tabulates the code size of each variant.
+#
+# Usage: ./handoff_matrix.sh -I<path/to/CMSIS/Include> -I<path/to/HAL/Inc> ...
+#
+# All arguments pass through to the compiler, so add the include paths for
+# the STM32 HAL and CMSIS headers plus any other device settings. Needs
+# arm-none-eabi-gcc and binutils; clang variants run only if clang is on the
+# path and can find an arm-none-eabi C library, and show as skipped otherwise.
+# Exits non-zero if any variant fails to build or fails the stack check.
+
+set -u
+
+SRC=$(dirname "$0")/stm32xx_dfu.c
+FUNCS="vJumpToDFU prvHandoff"
+CPU="-mcpu=cortex-m4 -mthumb -mfloat-abi=hard -mfpu=fpv4-sp-d16"
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+COMPILERS="arm-none-eabi-gcc"
+command -v clang >/dev/null 2>&1 && COMPILERS="$COMPILERS clang"
+
+status=0
+printf '%-18s %-5s %6s %6s  %s\n' compiler flags bytes insns stack-after-MSP
+for cc in $COMPILERS; do
+  case $cc in
+  clang) target="--target=arm-none-eabi" ;;
+  *) target="" ;;
+  esac
+  # Without an arm-none-eabi sysroot, clang cannot even find <stdint.h>.
+  # That says nothing about the hand-off, so skip rather than fail.
+  if ! echo '#include <stdint.h>' | $cc $target $CPU -x c -c - -o "$TMP/probe.o" "$@" 2>/dev/null; then
+    printf '%-18s %-5s %6s %6s  %s\n' "$cc" - - - "skipped (no sysroot)"
+    continue
+  fi
+  for opt in -O0 -Og -Os -O2 -O3; do
+    obj=$TMP/dfu$opt.o
+    if ! $cc $target $CPU -DSTM32F407xx $opt -ffunction-sections -c "$SRC" -o "$obj" "$@" 2>"$TMP/err"; then
+      printf '%-18s %-5s %6s %6s  %s\n' "$cc" "$opt" - - "build failed"
+      status=1
+      continue
+    fi
+    bytes=0
+    : >"$TMP/dis"
+    for func in $FUNCS; do
+      hex=$(arm-none-eabi-nm -S "$obj" | awk -v f="$func" '$4 == f { print $2 }')
+      bytes=$((bytes + 0x${hex:-0}))
+      arm-none-eabi-objdump -d --no-show-raw-insn --disassemble="$func" "$obj" |
+        grep -E '^ +[0-9a-f]+:' >>"$TMP/dis"
+    done
+    insns=$(wc -l <"$TMP/dis")
+    # Any instruction naming sp between the MSR to MSP and the branch away
+    # reads or writes the new stack, not the one the compiler thinks it has.
+    # No MSR at all means the disassembly is not what this check expects.
+    # Plain POSIX awk: no word-boundary escapes.
+    verdict=$(awk '
+      /msr[ \t]+(MSP|msp)/ { seen = 1; after = 1; next }
+      after && /(^|[^a-z])(blx|bx)([^a-z]|$)/ { exit }
+      after && /(^|[^a-z])sp([^a-z]|$)|push|pop/ { bad = 1 }
+      END { print (bad || !seen) ? "FAIL" : "ok" }' "$TMP/dis")
+    [ "$verdict" = ok ] || status=1
+    printf '%-18s %-5s %6s %6s  %s\n' "$cc" "$opt" "$bytes" "$insns" "$verdict"
+  done
+done
+exit $status
@@ -0,0 +1,143 @@
+/* SPDX-License-Identifier: MIT */
+/*!
+ * \file stm32xx_backup.c
+ * \brief Compressed flash readout for fast forensic backup over UPLOAD.
+ * \copyright 2025, Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sub-license, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial
+ *      portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "stm32xx_backup.h"
+
+#include <string.h> /* for memcpy, memset */
+
+/*!
+ * \brief Longest literal, repeat and erased runs per token.
+ */
+#define LITERAL_MAX 128U
+#define REPEAT_MIN 3U
+#define REPEAT_MAX 65U
+#define PADDING 0xbfU
+#define ERASED_MAX 16384U
+
+/*!
+ * \brief Counts erased words from \p pucAt, up to #ERASED_MAX.
+ */
+static uint32_t prvErasedWords(const uint8_t *pucAt, const uint8_t *pucEnd) {
+  if (((uintptr_t)pucAt & 3U) != 0U)
+    return 0U;
+  const uint32_t *pulAt = (const uint32_t *)pucAt;
+  uint32_t ulWords = 0U;
+  while (ulWords < ERASED_MAX && (const uint8_t *)(pulAt + 1) <= pucEnd && *pulAt == 0xffffffffUL) {
+    pulAt++;
+    ulWords++;
+  }
+  return ulWords;
+}
+
+/*!
+ * \brief Counts repeats of the byte at \p pucAt, up to #REPEAT_MAX.
+ */
+static uint32_t prvRepeats(const uint8_t *pucAt, const uint8_t *pucEnd) {
+  uint32_t ulRepeats = 1U;
+  while (ulRepeats < REPEAT_MAX && pucAt + ulRepeats < pucEnd && pucAt[ulRepeats] == pucAt[0])
+    ulRepeats++;
+  return ulRepeats;
+}
+
+void vBackupBegin(BackupStream_t *pxStream, const void *pvAddress, size_t xLength) {
+  pxStream->pucNext = (const uint8_t *)pvAddress;
+  pxStream->pucEnd = pxStream->pucNext + xLength;
+}
+
+size_t xBackupRead(BackupStream_t *pxStream, uint8_t *pucBlock, size_t xLength) {
+  const uint8_t *pucNext = pxStream->pucNext;
+  size_t xOut = 0U;
+  while (pucNext < pxStream->pucEnd && xOut < xLength) {
+    /*
+     * One byte left and flash still to go: every token needs at least two,
+     * so pad the block out to full length.
+     */
+    if (xLength - xOut == 1U) {
+      pucBlock[xOut++] = PADDING;
+      break;
+    }
+    uint32_t ulWords = prvErasedWords(pucNext, pxStream->pucEnd);
+    if (ulWords != 0U) {
+      pucBlock[xOut++] = (uint8_t)(0xc0U | ((ulWords - 1U) >> 8));
+      pucBlock[xOut++] = (uint8_t)(ulWords - 1U);
+      pucNext += 4U * ulWords;
+      continue;
+    }
+    uint32_t ulRepeats = prvRepeats(pucNext, pxStream->pucEnd);
+    if (ulRepeats >= REPEAT_MIN) {
+      pucBlock[xOut++] = (uint8_t)(0x80U + ulRepeats - REPEAT_MIN);
+      pucBlock[xOut++] = *pucNext;
+      pucNext += ulRepeats;
+      continue;
+    }
+    /*
+     * Gather literals until a run worth encoding starts, the literal token is
+     * full or the block is.
+     */
+    size_t xRoom = xLength - xOut - 1U;
+    size_t xLiterals = 0U;
+    while (xLiterals < LITERAL_MAX && xLiterals < xRoom && pucNext + xLiterals < pxStream->pucEnd) {
+      if (xLiterals != 0U && (prvErasedWords(pucNext + xLiterals, pxStream->pucEnd) != 0U ||
+                              prvRepeats(pucNext + xLiterals, pxStream->pucEnd) >= REPEAT_MIN))
+        break;
+      xLiterals++;
+    }
+    pucBlock[xOut++] = (uint8_t)(xLiterals - 1U);
+    memcpy(pucBlock + xOut, pucNext, xLiterals);
+    xOut += xLiterals;
+    pucNext += xLiterals;
+  }
+  pxStream->pucNext = pucNext;
+  return xOut;
+}
+
+size_t xBackupExpand(const uint8_t *pucIn, size_t xInLength, uint8_t *pucOut, size_t xOutLength) {
+  size_t xIn = 0U, xOut = 0U;
+  while (xIn < xInLength) {
+    uint8_t ucControl = pucIn[xIn++];
+    size_t xRun;
+    if (ucControl == PADDING)
+      continue;
+    if (ucControl < 0x80U) {
+      xRun = ucControl + 1U;
+      if (xInLength - xIn < xRun || xOutLength - xOut < xRun)
+        return (size_t)-1;
+      memcpy(pucOut + xOut, pucIn + xIn, xRun);
+      xIn += xRun;
+    } else {
+      if (xIn == xInLength)
+        return (size_t)-1;
+      uint8_t ucNext = pucIn[xIn++];
+      if (ucControl < 0xc0U) {
+        xRun = ucControl - 0x80U + REPEAT_MIN;
+        if (xOutLength - xOut < xRun)
+          return (size_t)-1;
+        memset(pucOut + xOut, ucNext, xRun);
+      } else {
+        xRun = 4U * ((((size_t)ucControl & 0x3fU) << 8 | ucNext) + 1U);
+        if (xOutLength - xOut < xRun)
+          return (size_t)-1;
+        memset(pucOut + xOut, 0xff, xRun);
+      }
+    }
+    xOut += xRun;
+  }
+  return xOut;
+}
@@ -0,0 +1,85 @@
+/* SPDX-License-Identifier: MIT */
+/*!
+ * \file stm32xx_backup.h
+ * \brief Compressed flash readout for fast forensic backup over UPLOAD.
+ * \author Roy Ratcliffe
+ * \date 2026-10-18
+ * \copyright 2025, Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sub-license, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial
+ *      portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h> /* for size_t */
+#include <stdint.h> /* for uint32_t */
+
+/*
+ * Token format. Every token starts with one control byte:
+ *
+ *   0x00-0x7f  n+1 literal bytes follow (1 to 128).
+ *   0x80-0xbe  the next byte repeats n-0x80+3 times (3 to 65).
+ *   0xbf       padding; no data. Fills the last byte of a block that has
+ *              no room for a two-byte token.
+ *   0xc0-0xff  with the next byte b: ((n & 0x3f) << 8 | b) + 1 erased words
+ *              of 0xffffffff (1 to 16384 words, up to 64 KiB).
+ */
+
+/*!
+ * \brief Position in a backup readout.
+ */
+typedef struct {
+  const uint8_t *pucNext; /*!< Next flash byte to encode. */
+  const uint8_t *pucEnd;  /*!< One past the last flash byte. */
+} BackupStream_t;
+
+/*!
+ * \brief Starts a compressed readout of a flash region.
+ * \param pxStream Stream state, owned by the caller.
+ * \param pvAddress Start of the region, word aligned for erased-run
+ * detection. Flash on the target, any buffer on a host.
+ * \param xLength Bytes to read.
+ */
+void vBackupBegin(BackupStream_t *pxStream, const void *pvAddress, size_t xLength);
+
+/*!
+ * \brief Encodes the next part of the readout into one UPLOAD block.
+ * \param pxStream Stream state.
+ * \param pucBlock Block buffer.
+ * \param xLength Block size; at least two bytes.
+ * \returns Bytes written, whole tokens only. Exactly \p xLength while any
+ * flash remains after the block, padded if need be; fewer, possibly zero,
+ * only for the last block. A short block is therefore always the DFU end of
+ * UPLOAD and never truncates the backup.
+ *
+ * Runs of erased words cost two bytes per 64 KiB and other repeated bytes
+ * two bytes per run. Everything else costs one extra byte in 129. The encoder
+ * reads flash once and keeps no history, so it runs at close to flash read
+ * speed.
+ */
+size_t xBackupRead(BackupStream_t *pxStream, uint8_t *pucBlock, size_t xLength);
+
+/*!
+ * \brief Expands a concatenation of blocks back into the flash image.
+ * \param pucIn Encoded bytes.
+ * \param xInLength Encoded length.
+ * \param pucOut Image buffer.
+ * \param xOutLength Image buffer size.
+ * \returns Image bytes written, or \c (size_t)-1 if the input is truncated or
+ * overflows \p pucOut.
+ *
+ * Portable C for use in host tooling as well. Check the result against the
+ * device's own CRC-32 of the region.
+ */
+size_t xBackupExpand(const uint8_t *pucIn, size_t xInLength, uint8_t *pucOut, size_t xOutLength);
@@ -0,0 +1,97 @@
+/* SPDX-License-Identifier: MIT */
+/*!
+ * \file stm32xx_crc.h
+ * \brief CRC-32 as used by DfuSe file suffixes and by the STM32 CRC unit.
+ * \author Roy Ratcliffe
+ * \date 2026-10-18
+ * \copyright 2025, Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sub-license, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial
+ *      portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h> /* for size_t */
+#include <stdint.h> /* for uint32_t */
+
+/*!
+ * \brief Selects eight-bytes-at-a-time table look-up.
+ * \details Costs 8 KiB of tables rather than 1 KiB and runs several times
+ * faster. On by default for little-endian hosts, where catalogue validation
+ * runs; off by default on Arm targets, where flash is scarce.
+ */
+#ifndef CRC32_SLICE_BY_8
+#if !defined(__arm__) && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define CRC32_SLICE_BY_8 1
+#else
+#define CRC32_SLICE_BY_8 0
+#endif
+#endif
+
+/*!
+ * \brief Initial value for a running CRC-32.
+ */
+#define CRC32_INIT 0xffffffffUL
+
+/*!
+ * \brief Accumulates bytes into a running CRC-32.
+ * \param ulCRC Running value, #CRC32_INIT to start.
+ * \param pvData Bytes to add.
+ * \param xLength Number of bytes.
+ * \returns Updated running value. Complement it to finish.
+ *
+ * Reflected polynomial \c 0xedb88320, the CRC-32 of IEEE 802.3, zlib and the
+ * DfuSe file suffix. Note that DfuSe stores the running value without the
+ * final complement.
+ */
+uint32_t ulCRC32Update(uint32_t ulCRC, const void *pvData, size_t xLength);
+
+/*!
+ * \brief Computes the finished CRC-32 of a block.
+ */
+static inline uint32_t ulCRC32(const void *pvData, size_t xLength) {
+  return ~ulCRC32Update(CRC32_INIT, pvData, xLength);
+}
+
+/*!
+ * \brief Initial value of the STM32 CRC unit after reset.
+ */
+#define CRC32_STM32_INIT 0xffffffffUL
+
+/*!
+ * \brief Accumulates words exactly as the STM32 CRC unit does.
+ * \param ulCRC Running value, #CRC32_STM32_INIT to start.
+ * \param pulData Words to add, each as written to the \c DR register.
+ * \param xWords Number of words.
+ * \returns Updated value, as read back from \c DR; there is no final
+ * complement.
+ *
+ * Polynomial \c 0x04c11db7, not reflected, most significant bit of each word
+ * first: CRC-32/MPEG-2 over the words' big-endian bytes. Host tools use it to
+ * reproduce checksums the device computes in hardware.
+ */
+uint32_t ulCRC32STM32Update(uint32_t ulCRC, const uint32_t *pulData, size_t xWords);
+
+#ifdef __arm__
+/*!
+ * \brief Computes the STM32 CRC of a block with the CRC unit.
+ * \param pulData Words to add.
+ * \param xWords Number of words.
+ * \returns The same value as ulCRC32STM32Update() from #CRC32_STM32_INIT.
+ *
+ * Resets the unit first. Enable its clock beforehand. Not re-entrant: the
+ * unit holds one running value.
+ */
+uint32_t ulCRC32STM32Hardware(const uint32_t *pulData, size_t xWords);
+#endif
@@ -39,7 +39,34 @@
       (_regs_)[addr] = (_data_);                                               \
   while (0)
 
-void vJumpToDFU(const uint32_t *pulMSP_PC) {
+/*!
+ * \brief Expands a macro argument to a string literal.
+ */
+#define STRINGIFY(_x_) #_x_
+#define XSTRINGIFY(_x_) STRINGIFY(_x_)
+
+/*!
+ * \brief Thumb state bit of the program status register.
+ */
+#define XPSR_T 0x01000000UL
+
+/*!
+ * \brief Exception return to thread mode on the main stack, basic frame.
+ */
+#define EXC_RETURN_THREAD_MSP 0xfffffff9UL
+
+/*!
+ * \brief Exception return to handler mode on the main stack, basic frame.
+ */
+#define EXC_RETURN_HANDLER_MSP 0xfffffff1UL
+
+/*!
+ * \brief Quiesces the core ahead of a hand-off.
+ * \details Disables interrupts, stops SysTick and clears all NVIC enable and
+ * pending bits. Leaves interrupts globally disabled; the caller re-enables them
+ * once it has finished any further core set-up.
+ */
+static void prvQuiesce(void) {
   /*
    * Disable interrupts upfront.
    * This is essential to prevent any further scheduling or interrupts pre-empting
@@ -71,6 +98,182 @@ void vJumpToDFU(const uint32_t *pulMSP_PC) {
    * mode after re-enabling interrupts.
    */
   WR_ALL_REGS(NVIC->ICPR, 0xffffffffUL);
+}
+
+#ifndef NDEBUG
+#if defined(__MPU_PRESENT) && __MPU_PRESENT == 1
+#define SNAPSHOT_MPU 1U
+#else
+#define SNAPSHOT_MPU 0U
+#endif
+#if defined(__FPU_PRESENT) && __FPU_PRESENT == 1
+#define SNAPSHOT_FPU 2U
+#else
+#define SNAPSHOT_FPU 0U
+#endif
+
+/*!
+ * \brief Register values captured just before the hand-off.
+ * \details Debug builds only. The order follows prvSnapshot(): the twelve
+ * SysTick, SCB and mask registers, then \c VTOR, SysTick \c VAL and, where
+ * present, MPU \c CTRL, \c FPCCR and \c CPACR. Lives on the caller's stack,
+ * never in static storage: called through the loader's service table, the
+ * loader's RAM belongs to the application.
+ */
+typedef struct {
+  uint32_t ulValue[14U + SNAPSHOT_MPU + SNAPSHOT_FPU];
+  uint32_t ulMismatch; /*!< One bit per \c ulValue entry that missed its reset value. */
+} CanonicalSnapshot_t;
+
+/*!
+ * \brief Captures the core system registers and checks them against their
+ * reset values.
+ * \param pxSnapshot Receives the register values and the mismatch bits.
+ */
+static void prvSnapshot(CanonicalSnapshot_t *pxSnapshot) {
+  const struct {
+    uint32_t ulValue;
+    uint32_t ulMask;
+    uint32_t ulReset;
+  } xRegisters[] = {
+      {SysTick->CTRL, 0xffffffffUL, 0UL},
+      {SysTick->LOAD, 0x00ffffffUL, 0UL},
+      {SCB->ICSR, SCB_ICSR_PENDSVSET_Msk | SCB_ICSR_PENDSTSET_Msk, 0UL},
+      {SCB->SHCSR, SCB_SHCSR_MEMFAULTENA_Msk | SCB_SHCSR_BUSFAULTENA_Msk | SCB_SHCSR_USGFAULTENA_Msk, 0UL},
+      {((volatile uint32_t *)SCB->SHP)[0], 0xffffffffUL, 0UL},
+      {((volatile uint32_t *)SCB->SHP)[1], 0xffffffffUL, 0UL},
+      {((volatile uint32_t *)SCB->SHP)[2], 0xffffffffUL, 0UL},
+      {SCB->SCR, 0xffffffffUL, 0UL},
+      {SCB->CFSR, 0xffffffffUL, 0UL},
+      {SCB->HFSR, 0xffffffffUL, 0UL},
+      {__get_BASEPRI(), 0xffffffffUL, 0UL},
+      {__get_FAULTMASK(), 0xffffffffUL, 0UL},
+      {SCB->VTOR, 0xffffffffUL, 0UL},
+      {SysTick->VAL, 0x00ffffffUL, 0UL},
+#if defined(__MPU_PRESENT) && __MPU_PRESENT == 1
+      {MPU->CTRL, 0xffffffffUL, 0UL},
+#endif
+#if defined(__FPU_PRESENT) && __FPU_PRESENT == 1
+      {FPU->FPCCR, 0xffffffffUL, FPU_FPCCR_ASPEN_Msk | FPU_FPCCR_LSPEN_Msk},
+      {SCB->CPACR, 0xffffffffUL, 0UL},
+#endif
+  };
+  _Static_assert(sizeof(xRegisters) / sizeof(xRegisters[0]) ==
+                     sizeof(pxSnapshot->ulValue) / sizeof(pxSnapshot->ulValue[0]),
+                 "one snapshot word per register");
+  uint32_t ulMismatch = 0UL;
+  for (size_t xIndex = 0; xIndex < sizeof(xRegisters) / sizeof(xRegisters[0]); xIndex++) {
+    pxSnapshot->ulValue[xIndex] = xRegisters[xIndex].ulValue;
+    if ((xRegisters[xIndex].ulValue & xRegisters[xIndex].ulMask) != xRegisters[xIndex].ulReset)
+      ulMismatch |= 1UL << xIndex;
+  }
+  pxSnapshot->ulMismatch = ulMismatch;
+}
+#endif
+/*!
+ * \brief Puts the core system registers back to their reset values.
+ * \details Expects the core already quiesced. One store per register:
+ * SysTick reload and current value, the PendSV and SysTick pending bits, the
+ * configurable fault enables, the system handler priorities (three word
+ * stores rather than twelve byte stores), sleep control, the sticky fault
+ * status, the vector table offset, \c BASEPRI, \c FAULTMASK, the MPU, the
+ * floating-point context control and the coprocessor access. The boot loader
+ * then starts from the state it was written and tested against, not one
+ * left behind by the application.
+ *
+ * Leaves \c CONTROL alone: changing the stack selection in the middle of a C
+ * function would move its stack. The hand-off trampolines reset \c CONTROL
+ * themselves. Leaves the active bits in \c SHCSR alone too; only exception
+ * return may clear them. NVIC priorities are also left as they are, since
+ * every NVIC interrupt is already disabled and the boot loader sets the
+ * priorities it needs.
+ */
+static void prvCanonicalise(void) {
+  SysTick->LOAD = 0UL;
+  SysTick->VAL = 0UL;
+  SCB->ICSR = SCB_ICSR_PENDSVCLR_Msk | SCB_ICSR_PENDSTCLR_Msk;
+  SCB->SHCSR &= ~(SCB_SHCSR_MEMFAULTENA_Msk | SCB_SHCSR_BUSFAULTENA_Msk | SCB_SHCSR_USGFAULTENA_Msk);
+  ((volatile uint32_t *)SCB->SHP)[0] = 0UL;
+  ((volatile uint32_t *)SCB->SHP)[1] = 0UL;
+  ((volatile uint32_t *)SCB->SHP)[2] = 0UL;
+  SCB->SCR = 0UL;
+  SCB->CFSR = SCB->CFSR;
+  SCB->HFSR = SCB->HFSR;
+  SCB->VTOR = 0UL;
+  __set_BASEPRI(0UL);
+  __set_FAULTMASK(0UL);
+#if defined(__MPU_PRESENT) && __MPU_PRESENT == 1
+  MPU->CTRL = 0UL;
+#endif
+#if defined(__FPU_PRESENT) && __FPU_PRESENT == 1
+  FPU->FPCCR = FPU_FPCCR_ASPEN_Msk | FPU_FPCCR_LSPEN_Msk;
+  SCB->CPACR = 0UL;
+#endif
+  __DSB();
+  __ISB();
+#ifndef NDEBUG
+  /*
+   * With a debugger attached, stop on a miss so that the snapshot can be
+   * inspected in this frame. Without one, a breakpoint would escalate to a
+   * hard fault, so carry on.
+   */
+  CanonicalSnapshot_t xSnapshot;
+  prvSnapshot(&xSnapshot);
+  if (xSnapshot.ulMismatch != 0UL && (CoreDebug->DHCSR & CoreDebug_DHCSR_C_DEBUGEN_Msk) != 0UL)
+    __BKPT(0);
+#endif
+}
+
+/*!
+ * \brief Switches the main stack and branches, without using the stack.
+ * \param pulMSP_PC Pointer to the new main stack pointer and entry point,
+ * passed in \c r0.
+ * \details Written as a naked function so the compiler adds no prologue and
+ * cannot spill anything. Both words load into registers first; only then does
+ * \c MSR switch the stack. Clearing \c CONTROL then selects the main stack
+ * in privileged mode with no floating-point context, exactly as after reset,
+ * and \c BX branches to the entry point. Calling
+ * \c __set_MSP() followed by a C function-pointer call leaves the second load
+ * to the compiler. Unoptimised builds then often reload \p pulMSP_PC from the
+ * stack after the stack has already moved.
+ * \note A naked function may contain only basic assembler, so the compiler
+ * cannot know that it never returns. Callers follow it with
+ * \c __builtin_unreachable().
+ */
+__attribute__((naked)) static void prvHandoff(__attribute__((unused)) const uint32_t *pulMSP_PC) {
+  __ASM volatile("ldr r1, [r0, #4]\n"
+                 "ldr r0, [r0]\n"
+                 "msr msp, r0\n"
+                 "movs r2, #0\n"
+                 "msr control, r2\n"
+                 "isb\n"
+                 "bx r1\n");
+}
+
+void vDFUCanonicalise(void) { prvCanonicalise(); }
+
+static void prvUnwind(const uint32_t *pulMSP_PC) __attribute__((noreturn));
+
+void vJumpToDFU(const uint32_t *pulMSP_PC) {
+  /*
+   * Quiesce the core: interrupts, SysTick and the NVIC.
+   */
+  prvQuiesce();
+
+  /*
+   * Put the core system registers back to their reset values.
+   */
+  prvCanonicalise();
+
+  /*
+   * Called from an interrupt or fault handler?
+   * Jumping straight to the boot loader would leave it running in handler
+   * mode with the exception still active, so every interrupt at the same or
+   * lower priority, USB included, would stay blocked. Return from each active
+   * exception instead, ending in thread mode at the DFU entry point.
+   */
+  if ((__get_IPSR() & IPSR_ISR_Msk) != 0UL)
+    prvUnwind(pulMSP_PC);
 
   /*
    * Enable interrupts again.
@@ -83,27 +286,204 @@ void vJumpToDFU(const uint32_t *pulMSP_PC) {
   __enable_irq();
 
   /*
-   * Set the main stack pointer to the value provided in the pul parameter.
-   * This is necessary to ensure that the core starts executing code from the
-   * correct stack.
-   */
-  __set_MSP(pulMSP_PC[0]);
-
-  /*
-   * Jump to the DFU entry point.
+   * Set the main stack pointer and jump to the DFU entry point.
    * The boot loader is responsible for handling the actual firmware update
    * process, including reading the new firmware, writing it to the
    * appropriate memory locations, and verifying its integrity.
+   * The trampoline never touches the stack after the switch, whatever the
+   * optimisation level, and branches rather than calls so there is no way
+   * back into this function.
+   */
+  prvHandoff(pulMSP_PC);
+  __builtin_unreachable();
+}
+
+void vJumpToImage(const uint32_t *pulVectors) {
+  /*
+   * Quiesce and canonicalise the core exactly as for DFU.
+   */
+  prvQuiesce();
+  prvCanonicalise();
+
+  /*
+   * Relocate the vector table to the image.
+   * Interrupts remain globally disabled and the NVIC is clear, so nothing can
+   * vector through the old table in between. The barriers make sure the new
+   * table takes effect before any exception can be taken.
+   */
+  SCB->VTOR = (uint32_t)pulVectors;
+  __DSB();
+  __ISB();
+
+  if ((__get_IPSR() & IPSR_ISR_Msk) != 0UL)
+    prvUnwind(pulVectors);
+
+  /*
+   * Enable interrupts again, just as the core would see them after reset.
    */
-  ((void (*)(void))(pulMSP_PC[1]))();
+  __enable_irq();
 
   /*
-   * Enter an infinite loop after jumping to the DFU entry point.
-   * This is necessary to prevent the execution of any further code if the
-   * DFU process returns.
-   * The boot loader is expected to handle the firmware update process and
-   * will not return to this function.
+   * Load the image's initial stack pointer and branch to its reset handler.
    */
-  while (1)
-    ;
+  prvHandoff(pulVectors);
+  __builtin_unreachable();
+}
+
+/*!
+ * \brief Leaves the current exception for \p ulPC on a fresh main stack.
+ * \param ulSP Main stack pointer once the exception has returned.
+ * \param ulPC Address to return to, with the Thumb bit clear.
+ * \param ulxPSR Program status to return with.
+ * \param ulEXC_RETURN Exception return value.
+ * \param ulR0 Value for the frame's \c r0, so the first argument of a C
+ * function at \p ulPC.
+ * \details Switches the main stack to \p ulSP less one basic frame, writes
+ * the frame's \c r0, return address and program status, and branches to
+ * \p ulEXC_RETURN. The core pops the frame, so execution resumes at \p ulPC
+ * with the stack pointer at exactly \p ulSP. The frame's link register reads
+ * as \c 0xffffffff; its other registers are don't-care. The fifth argument
+ * arrives on the old stack, so it loads into \c r12 before the switch.
+ */
+__attribute__((naked)) static void prvExceptionReturn(__attribute__((unused)) uint32_t ulSP,
+                                                      __attribute__((unused)) uint32_t ulPC,
+                                                      __attribute__((unused)) uint32_t ulxPSR,
+                                                      __attribute__((unused)) uint32_t ulEXC_RETURN,
+                                                      __attribute__((unused)) uint32_t ulR0) {
+  __ASM volatile("ldr r12, [sp]\n"
+                 "msr msp, r0\n"
+                 "sub sp, sp, #32\n"
+                 "str r12, [sp]\n"
+                 "str r1, [sp, #24]\n"
+                 "str r2, [sp, #28]\n"
+                 "mvn r1, #0\n"
+                 "str r1, [sp, #20]\n"
+                 "bx r3\n");
 }
+
+/*!
+ * \brief Hands off to the DFU entry point from handler mode.
+ * \param pulMSP_PC DFU main stack pointer and entry point.
+ * \details Expects the core already quiesced and canonicalised. Resets
+ * \c CONTROL to privileged with no floating-point context; in handler mode
+ * that leaves the stack selection alone. Then it exception-returns to the
+ * entry point in thread mode on the main stack.
+ */
+static void prvHandlerHandoff(const uint32_t *pulMSP_PC) {
+  __set_CONTROL(0UL);
+  __enable_irq();
+  prvExceptionReturn(pulMSP_PC[0], pulMSP_PC[1] & ~1UL, XPSR_T, EXC_RETURN_THREAD_MSP, 0UL);
+  __builtin_unreachable();
+}
+
+/*!
+ * \brief Finds an active exception other than \p ulCurrent.
+ * \param ulCurrent Exception number now executing.
+ * \returns Exception number of another active exception, or zero if
+ * \p ulCurrent is the only one.
+ * \details System handlers report their active state in \c SHCSR, external
+ * interrupts in the NVIC's active bit registers. A hard fault or NMI can only
+ * be active while executing, so it is always \p ulCurrent.
+ */
+static uint32_t prvOtherActive(uint32_t ulCurrent) {
+  static const struct {
+    uint32_t ulMask;
+    uint32_t ulNumber;
+  } xSystem[] = {
+      {SCB_SHCSR_MEMFAULTACT_Msk, 4UL}, {SCB_SHCSR_BUSFAULTACT_Msk, 5UL}, {SCB_SHCSR_USGFAULTACT_Msk, 6UL},
+      {SCB_SHCSR_SVCALLACT_Msk, 11UL},  {SCB_SHCSR_MONITORACT_Msk, 12UL}, {SCB_SHCSR_PENDSVACT_Msk, 14UL},
+      {SCB_SHCSR_SYSTICKACT_Msk, 15UL},
+  };
+  uint32_t ulSHCSR = SCB->SHCSR;
+  for (size_t xIndex = 0; xIndex < sizeof(xSystem) / sizeof(xSystem[0]); xIndex++)
+    if ((ulSHCSR & xSystem[xIndex].ulMask) != 0UL && xSystem[xIndex].ulNumber != ulCurrent)
+      return xSystem[xIndex].ulNumber;
+  for (size_t xWord = 0; xWord < sizeof(NVIC->IABR) / sizeof(NVIC->IABR[0]); xWord++) {
+    uint32_t ulActive = NVIC->IABR[xWord];
+    if (ulCurrent >= 16UL + 32UL * xWord && ulCurrent < 16UL + 32UL * (xWord + 1UL))
+      ulActive &= ~(1UL << (ulCurrent - 16UL - 32UL * xWord));
+    if (ulActive != 0UL)
+      return 16UL + 32UL * xWord + (uint32_t)__builtin_ctz(ulActive);
+  }
+  return 0UL;
+}
+
+/*!
+ * \brief One unwinding step, entered by a synthesised exception return.
+ * \param pulMSP_PC DFU main stack pointer and entry point, carried in the
+ * synthesised frame's \c r0 rather than in static storage. Nothing here
+ * touches memory outside the boot loader's fresh stack, so the unwinding is
+ * reentrant and leaves no trace in the caller's RAM.
+ */
+static void prvUnwindStep(const uint32_t *pulMSP_PC) {
+  uint32_t ulNext = prvOtherActive(__get_IPSR() & IPSR_ISR_Msk);
+  if (ulNext == 0UL)
+    prvHandlerHandoff(pulMSP_PC);
+  else
+    prvExceptionReturn(pulMSP_PC[0], (uint32_t)prvUnwindStep & ~1UL, XPSR_T | ulNext, EXC_RETURN_HANDLER_MSP,
+                       (uint32_t)pulMSP_PC);
+  __builtin_unreachable();
+}
+
+/*!
+ * \brief Returns from every active exception, then hands off from thread mode.
+ * \param pulMSP_PC DFU main stack pointer and entry point.
+ * \details Expects the core already quiesced and in handler mode. While
+ * another exception remains active, returns from the current one into a
+ * synthesised handler-mode frame for that other exception, which repeats the
+ * step. Each return deactivates one exception. The last step canonicalises the
+ * core and returns to the entry point in thread mode with no exception active,
+ * so the boot loader sees a clean priority state. Interrupts stay masked
+ * until that final return. Every step runs on the boot loader's fresh stack.
+ */
+static void prvUnwind(const uint32_t *pulMSP_PC) {
+  prvUnwindStep(pulMSP_PC);
+  __builtin_unreachable();
+}
+
+void vRequestDFU(const uint32_t *pulMSP_PC) {
+  register const uint32_t *r0 __ASM("r0") = pulMSP_PC;
+  __ASM volatile("svc %0" : : "i"(DFU_SVC_NUMBER), "r"(r0) : "memory");
+  __builtin_unreachable();
+}
+
+/*!
+ * \brief Services the DFU supervisor call.
+ * \param pulFrame Caller's stacked exception frame; its first word is the
+ * caller's \c r0, the argument to vRequestDFU().
+ * \details External linkage only so that vDFUSVCHandler() can branch to it.
+ */
+__attribute__((used)) void vDFUSVC(uint32_t *pulFrame);
+
+void vDFUSVC(uint32_t *pulFrame) {
+  const uint32_t *pulMSP_PC = (const uint32_t *)pulFrame[0];
+  prvQuiesce();
+  prvCanonicalise();
+  prvUnwind(pulMSP_PC);
+}
+
+/*
+ * Finds the caller's frame on whichever stack it used, reads the SVC number
+ * from the instruction before the stacked return address and dispatches.
+ * Nothing here touches r4 to r11 or the link register, so the chained handler
+ * sees the exception exactly as taken.
+ */
+__attribute__((naked)) void vDFUSVCHandler(void) {
+  __ASM volatile("tst lr, #4\n"
+                 "ite eq\n"
+                 "mrseq r0, msp\n"
+                 "mrsne r0, psp\n"
+                 "ldr r1, [r0, #24]\n"
+                 "ldrb r1, [r1, #-2]\n"
+                 "cmp r1, #" XSTRINGIFY(DFU_SVC_NUMBER) "\n"
+                 "bne 1f\n"
+                 "b vDFUSVC\n"
+                 "1:\n"
+                 "b vDFUSVCChain\n");
+}
+
+__attribute__((weak)) void vDFUSVCChain(void) {}
+
+#ifdef DFU_SVC_HANDLER_ALIAS
+void SVC_Handler(void) __attribute__((alias("vDFUSVCHandler")));
+#endif
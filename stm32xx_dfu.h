@@ -24,6 +24,10 @@
 
 #include <stdint.h> /* for uint32_t */
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /*!
  * \brief Initiates Device Firmware Update (DFU) mode.
  * \param pulMSP_PC Pointer to the DFU entry point address. The first element should
@@ -47,8 +51,14 @@
  * handling the actual firmware update process, including reading the new
  * firmware, writing it to the appropriate memory locations, and verifying its
  * integrity.
- * \note Enters an infinite loop after jumping to the DFU entry point in order
- * to prevent the execution of any further code if the DFU process returns.
+ * \note Loads the stack pointer and entry point into registers before
+ * switching the main stack, then branches with \c BX. Nothing touches the
+ * stack after the switch at any optimisation level, and the DFU entry point
+ * has no return path into the caller.
+ * \note Safe to call from an interrupt or fault handler, nested or not. In
+ * handler mode it returns from every active exception in turn and reaches the
+ * DFU entry point in thread mode, so the boot loader's own interrupts are not
+ * blocked by a stale active exception.
  * \warning Should only be called when the system is ready to enter DFU mode.
  * It will disable all interrupts and clear all interrupt enable and pending
  * registers, which may lead to loss of data or state if called at an
@@ -57,3 +67,107 @@
  * vary.
  */
 void vJumpToDFU(const uint32_t *pulMSP_PC) __attribute__((noreturn));
+
+/*!
+ * \brief Runs an image already loaded into memory, typically SRAM.
+ * \param pulVectors Pointer to the image's vector table. The first element is
+ * the initial main stack pointer, the second is the reset handler.
+ *
+ * Quiesces the core just like vJumpToDFU(), relocates the vector table by
+ * writing \c SCB->VTOR, then loads the main stack pointer and jumps to the
+ * reset handler. No flash is erased or programmed; use it for a developer
+ * "RAM boot" cycle where an image streams into SRAM (or CCM plus SRAM) and runs
+ * straight away.
+ *
+ * \note The vector table must satisfy the VTOR alignment rule: its address
+ * must be a multiple of the table size rounded up to a power of two. On
+ * STM32F4 that means 512-byte alignment.
+ * \note The image must be linked to run at the address it occupies. Its own
+ * start-up code should initialise \c .data and \c .bss as usual.
+ * \warning The same caveats apply as for vJumpToDFU(). The image replaces the
+ * running application; the function never returns.
+ */
+void vJumpToImage(const uint32_t *pulVectors) __attribute__((noreturn));
+
+/*!
+ * \brief Puts the core system registers back to their reset values.
+ * \details The canonicalisation step of vJumpToDFU(), for hand-offs built
+ * elsewhere such as the C++ jumpToDFU() template. Call it with interrupts
+ * masked, SysTick stopped and every NVIC interrupt disabled. Leaves
+ * \c CONTROL and the active exception bits alone. Debug builds also check
+ * the result, keeping the snapshot on the stack, and stop at a breakpoint on
+ * any miss when a debugger is attached.
+ */
+void vDFUCanonicalise(void);
+
+/*!
+ * \brief Supervisor call number that requests DFU mode.
+ * \details A plain integer literal from 0 to 255, since the assembler sees it
+ * too. Override it in the project settings if it clashes with another SVC
+ * user.
+ */
+#ifndef DFU_SVC_NUMBER
+#define DFU_SVC_NUMBER 223
+#endif
+
+/*!
+ * \brief Requests DFU mode from any thread context.
+ * \param pulMSP_PC Pointer to the DFU entry point's main stack pointer and
+ * program counter, as for vJumpToDFU().
+ *
+ * Raises supervisor call #DFU_SVC_NUMBER, so it works from privileged or
+ * unprivileged code, on the main or the process stack, with or without an
+ * active floating-point context. The SVC handler quiesces the core just like
+ * vJumpToDFU(). It resets \c CONTROL, abandons any pending lazy floating-point
+ * state and then exception-returns to the DFU entry point in privileged thread
+ * mode on the main stack, which is how the core comes out of reset.
+ *
+ * \note Needs vDFUSVCHandler() installed as the SVC handler.
+ * \warning Call with interrupts enabled. With \c PRIMASK set, the SVC
+ * escalates to a hard fault.
+ */
+void vRequestDFU(const uint32_t *pulMSP_PC) __attribute__((noreturn));
+
+/*!
+ * \brief SVC handler that services vRequestDFU().
+ *
+ * Install it as \c SVC_Handler, either by pointing the vector table at it or
+ * by defining #DFU_SVC_HANDLER_ALIAS. Supervisor calls with any other number
+ * pass to vDFUSVCChain() with the exception state intact.
+ */
+void vDFUSVCHandler(void);
+
+/*!
+ * \def DFU_SVC_HANDLER_ALIAS
+ * \brief Defines \c SVC_Handler as an alias of vDFUSVCHandler().
+ * \details Define it in the project settings, for example
+ * \c -DDFU_SVC_HANDLER_ALIAS, so that the strong alias overrides the start-up
+ * code's weak \c SVC_Handler without editing the vector table. Leave it
+ * undefined if something else already defines \c SVC_Handler.
+ */
+
+/*!
+ * \brief Handles supervisor calls other than #DFU_SVC_NUMBER.
+ * \details Entered by a tail branch from vDFUSVCHandler(), so it can itself be
+ * a complete SVC handler. The default does nothing and returns. A FreeRTOS
+ * application can hand the port's handler over by adding
+ * \code
+ * #define vPortSVCHandler vDFUSVCChain
+ * \endcode
+ * to \c FreeRTOSConfig.h in place of the usual \c SVC_Handler mapping, then
+ * building with #DFU_SVC_HANDLER_ALIAS so that \c SVC_Handler still exists and
+ * the scheduler's own supervisor call reaches the port.
+ *
+ * \note FreeRTOS 10.6 and later check at scheduler start that the SVC vector
+ * holds \c vPortSVCHandler itself. With this chaining it holds
+ * vDFUSVCHandler(), so the check fails its assertion. Add
+ * \code
+ * #define configCHECK_HANDLER_INSTALLATION 0
+ * \endcode
+ * as well.
+ */
+void vDFUSVCChain(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,154 @@
+/* SPDX-License-Identifier: MIT */
+/*!
+ * \file stm32xx_dfu.hpp
+ * \brief Device traits and compile-time specialised DFU hand-off for C++.
+ * \details Header-only. Each STM32 family gets a traits structure of
+ * \c constexpr values: the number of NVIC words actually implemented, the
+ * system-memory address and the flash geometry. The jumpToDFU() template reads
+ * them at compile time, so it emits exactly the register writes the part needs
+ * and no loop over unimplemented NVIC words.
+ * \author Roy Ratcliffe
+ * \date 2026-10-18
+ * \copyright 2025, Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sub-license, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial
+ *      portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "stm32xx_dfu.h"   /* for vJumpToDFU, vDFUCanonicalise */
+#include "stm32xx_flash.h" /* for STM32F407_SECTOR_SIZES */
+#include "stm32xx_hal.h" /* for HAL functions and definitions */
+
+#include <array>   /* for std::array */
+#include <cstddef> /* for std::size_t */
+#include <cstdint> /* for std::uint32_t */
+#include <utility> /* for std::index_sequence */
+
+namespace stm32xx {
+
+/*!
+ * \brief Sum of an array of sector sizes.
+ */
+template <std::size_t N> constexpr std::uint32_t sum(const std::array<std::uint32_t, N> &sizes) {
+  std::uint32_t total = 0;
+  for (auto size : sizes)
+    total += size;
+  return total;
+}
+
+/*!
+ * \brief STM32F405/407 traits.
+ * \details 82 maskable interrupts fit in three NVIC words. The system
+ * bootloader's MSP and PC pair sits at the start of system memory. Flash has
+ * four 16 KiB, one 64 KiB and seven 128 KiB sectors.
+ */
+struct STM32F407 {
+  static constexpr std::size_t irqCount = 82U;
+  static constexpr std::size_t nvicWords = (irqCount + 31U) / 32U;
+  static constexpr std::uint32_t systemMemory = 0x1fff0000UL;
+  static constexpr std::uint32_t flashBase = 0x08000000UL;
+  static constexpr std::uint32_t flashSize = 0x00100000UL;
+  static constexpr std::array<std::uint32_t, 12> sectorSizes = {STM32F407_SECTOR_SIZES};
+};
+
+/*!
+ * \brief STM32F411 traits.
+ * \details 86 maskable interrupts in three NVIC words. Flash has four 16 KiB,
+ * one 64 KiB and three 128 KiB sectors.
+ */
+struct STM32F411 {
+  static constexpr std::size_t irqCount = 86U;
+  static constexpr std::size_t nvicWords = (irqCount + 31U) / 32U;
+  static constexpr std::uint32_t systemMemory = 0x1fff0000UL;
+  static constexpr std::uint32_t flashBase = 0x08000000UL;
+  static constexpr std::uint32_t flashSize = 0x00080000UL;
+  static constexpr std::array<std::uint32_t, 8> sectorSizes = {STM32F411_SECTOR_SIZES};
+};
+
+/*!
+ * \brief Validates a traits table at compile time.
+ * \details Instantiated by jumpToDFU(), so a bad table fails to compile where
+ * it is used.
+ */
+template <typename Device> struct Validate {
+  static_assert(Device::nvicWords >= 1U, "device has no NVIC words");
+  static_assert(Device::nvicWords * sizeof(std::uint32_t) <= sizeof(NVIC_Type::ICER),
+                "device has more NVIC words than the core implements");
+  static_assert((Device::systemMemory & 3U) == 0U, "system memory must be word aligned");
+  static_assert(sum(Device::sectorSizes) == Device::flashSize, "sectors must cover flash exactly");
+  static constexpr bool value = true;
+};
+
+/*!
+ * \brief Clears NVIC enable and pending words 0 to N-1, unrolled.
+ */
+template <std::size_t... I> inline void clearNVIC(std::index_sequence<I...>) {
+  ((NVIC->ICER[I] = 0xffffffffUL), ...);
+  ((NVIC->ICPR[I] = 0xffffffffUL), ...);
+}
+
+/*!
+ * \brief Initiates the system bootloader's DFU mode on a known device.
+ * \tparam Device Traits structure, for example STM32F407.
+ *
+ * Quiesces the core like vJumpToDFU(), but clears only the NVIC words the
+ * part implements, fully unrolled, and reads the MSP and PC pair from the
+ * device's system memory at a constant address. Canonicalisation is shared:
+ * it calls vDFUCanonicalise(). The specialised path runs in thread mode only.
+ * From an interrupt or fault handler it defers to vJumpToDFU(), which
+ * returns from each active exception on the way to the DFU entry point.
+ */
+template <typename Device> [[noreturn]] inline void jumpToDFU() {
+  static_assert(Validate<Device>::value);
+  const auto *msp_pc = reinterpret_cast<const std::uint32_t *>(Device::systemMemory);
+  if ((__get_IPSR() & IPSR_ISR_Msk) != 0UL)
+    vJumpToDFU(msp_pc);
+  __disable_irq();
+  SysTick->CTRL = 0x00000000UL;
+  clearNVIC(std::make_index_sequence<Device::nvicWords>{});
+  vDFUCanonicalise();
+  __enable_irq();
+  // Both words are register operands, loaded before the MSR; nothing touches
+  // the stack between the switch and the branch. Clearing CONTROL selects the
+  // main stack, privileged, as after reset.
+  __ASM volatile("msr msp, %0\n"
+                 "msr control, %2\n"
+                 "isb\n"
+                 "bx %1\n"
+                 :
+                 : "r"(msp_pc[0]), "r"(msp_pc[1]), "r"(0UL));
+  __builtin_unreachable();
+}
+
+#ifdef STM32F407xx
+/*!
+ * \brief Traits of the device selected in the project settings.
+ */
+using Device = STM32F407;
+#endif
+
+} // namespace stm32xx
+
+/*!
+ * \brief Defines a C-callable wrapper around the specialised hand-off.
+ * \details Expand once in a single C++ translation unit, for example:
+ * \code
+ * STM32XX_DFU_C_WRAPPER(vJumpToSystemDFU, stm32xx::Device)
+ * \endcode
+ * C code then declares and calls \c vJumpToSystemDFU() with no argument.
+ * Existing vJumpToDFU() callers are unaffected.
+ */
+#define STM32XX_DFU_C_WRAPPER(_name_, _device_)                                \
+  extern "C" [[noreturn]] void _name_(void) { stm32xx::jumpToDFU<_device_>(); }
@@ -0,0 +1,94 @@
+/* SPDX-License-Identifier: MIT */
+/*!
+ * \file stm32xx_dfu_buf.c
+ * \brief Zero-copy download buffers passed from USB to flash by ownership.
+ * \details The usual USB device stack copies each DNLOAD block from packet
+ * memory into a class buffer, then into a flash staging buffer, then into
+ * flash. Here the OUT endpoint receives straight into a preallocated,
+ * word-aligned buffer, and the buffer itself moves from the USB stage to the
+ * flash stage and back. Only a pointer changes hands; the payload is never
+ * copied in RAM.
+ *
+ * The buffers form a ring with four cursors: \c ulReceive (next buffer USB
+ * claims), \c ulCommit (next buffer USB hands over), \c ulProgram (next buffer
+ * flash takes) and \c ulRelease (next buffer flash returns). USB writes
+ * \c ulReceive and \c ulCommit, flash writes \c ulProgram and \c ulRelease.
+ * With one writer per cursor, a single-core Cortex-M needs no locks, only
+ * ordering barriers.
+ * \copyright 2025, Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sub-license, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial
+ *      portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "stm32xx_dfu_buf.h"
+
+#include "stm32xx_hal.h" /* for HAL functions and definitions */
+
+#include <stddef.h> /* for NULL */
+
+/*!
+ * \brief Maps a free-running cursor to a ring slot.
+ */
+#define SLOT(_cursor_) ((_cursor_) & (DFU_BUF_COUNT - 1U))
+
+static DFUBuffer_t xBuffers[DFU_BUF_COUNT] __attribute__((aligned(4)));
+
+/*
+ * Free-running cursors. Unsigned wrap-around keeps the differences correct.
+ */
+static volatile uint32_t ulReceive, ulCommit, ulProgram, ulRelease;
+
+DFUBuffer_t *pxDFUBufferReceive(void) {
+  /*
+   * A buffer is empty once flash has released it. The difference between
+   * receive and release counts the buffers not yet back in the pool.
+   */
+  if (ulReceive - ulRelease >= DFU_BUF_COUNT)
+    return NULL;
+  return &xBuffers[SLOT(ulReceive++)];
+}
+
+int xDFUBufferCommit(DFUBuffer_t *pxBuffer) {
+  /*
+   * Buffers commit in the order received, so the only valid buffer is the
+   * oldest one received but not yet committed. Refuse anything else rather
+   * than publish the wrong slot.
+   */
+  if (ulCommit == ulReceive || pxBuffer != &xBuffers[SLOT(ulCommit)])
+    return -1;
+  /*
+   * Make the payload visible before publishing the buffer.
+   */
+  __DMB();
+  ulCommit++;
+  return 0;
+}
+
+DFUBuffer_t *pxDFUBufferProgram(void) {
+  if (ulProgram == ulCommit)
+    return NULL;
+  __DMB();
+  return &xBuffers[SLOT(ulProgram++)];
+}
+
+int xDFUBufferRelease(DFUBuffer_t *pxBuffer) {
+  /*
+   * Likewise, release in programming order only.
+   */
+  if (ulRelease == ulProgram || pxBuffer != &xBuffers[SLOT(ulRelease)])
+    return -1;
+  __DMB();
+  ulRelease++;
+  return 0;
+}
@@ -0,0 +1,99 @@
+/* SPDX-License-Identifier: MIT */
+/*!
+ * \file stm32xx_dfu_buf.h
+ * \brief Zero-copy download buffers passed from USB to flash by ownership.
+ * \author Roy Ratcliffe
+ * \date 2026-10-18
+ * \copyright 2025, Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sub-license, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial
+ *      portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdint.h> /* for uint32_t */
+
+/*!
+ * \brief Size of one download buffer in bytes.
+ * \details Matches the DFU transfer size, so one DNLOAD block fills exactly
+ * one buffer. Must be a multiple of four for word-wide flash programming.
+ */
+#ifndef DFU_BUF_SIZE
+#define DFU_BUF_SIZE 2048U
+#endif
+
+/*!
+ * \brief Number of download buffers, a power of two.
+ * \details Two buffers let USB receive one block while flash programs the
+ * other. More buffers absorb jitter in erase times.
+ */
+#ifndef DFU_BUF_COUNT
+#define DFU_BUF_COUNT 2U
+#endif
+
+_Static_assert((DFU_BUF_SIZE & 3U) == 0U, "DFU_BUF_SIZE must be a multiple of four");
+_Static_assert((DFU_BUF_COUNT & (DFU_BUF_COUNT - 1U)) == 0U, "DFU_BUF_COUNT must be a power of two");
+
+/*!
+ * \brief One download buffer.
+ * \details Word-aligned so the flash stage can program straight from it.
+ */
+typedef struct {
+  uint32_t ulAddress;                      /*!< Target flash address. */
+  uint32_t ulLength;                       /*!< Valid bytes in the buffer. */
+  uint32_t ulData[DFU_BUF_SIZE / 4U];      /*!< Payload. */
+} DFUBuffer_t;
+
+/*!
+ * \brief Claims the next empty buffer for USB to receive into.
+ * \returns Buffer owned by the USB stage, or \c NULL if every buffer is still
+ * waiting for flash. Point the OUT endpoint at \c ulData directly; in that case
+ * NAK the host until a buffer frees up.
+ *
+ * Call from the USB stage only: one producer.
+ */
+DFUBuffer_t *pxDFUBufferReceive(void);
+
+/*!
+ * \brief Hands a filled buffer from USB to flash.
+ * \param pxBuffer Buffer returned by pxDFUBufferReceive(). Once committed,
+ * USB must not touch it again.
+ *
+ * Buffers commit in the order received: \p pxBuffer must be the oldest one
+ * received and not yet committed.
+ * \returns 0 on success, or -1 for any other pointer, leaving the ring
+ * unchanged. A failure is a caller bug; left unchecked, the ring stalls.
+ *
+ * Safe to call from the USB interrupt.
+ */
+int xDFUBufferCommit(DFUBuffer_t *pxBuffer);
+
+/*!
+ * \brief Takes the oldest filled buffer for programming.
+ * \returns Buffer owned by the flash stage, or \c NULL if none is waiting.
+ *
+ * Call from the flash stage only: one consumer.
+ */
+DFUBuffer_t *pxDFUBufferProgram(void);
+
+/*!
+ * \brief Returns a programmed buffer to the empty pool.
+ * \param pxBuffer Buffer returned by pxDFUBufferProgram().
+ *
+ * Buffers release in the order taken: \p pxBuffer must be the oldest one
+ * taken and not yet released.
+ * \returns 0 on success, or -1 for any other pointer, leaving the ring
+ * unchanged.
+ */
+int xDFUBufferRelease(DFUBuffer_t *pxBuffer);
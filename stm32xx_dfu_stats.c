@@ -0,0 +1,121 @@
+/* SPDX-License-Identifier: MIT */
+/*!
+ * \file stm32xx_dfu_stats.c
+ * \brief Per-session update telemetry kept across resets.
+ * \details Records live in \c .noinit RAM, which start-up neither copies nor
+ * clears. They therefore survive the resets an update involves. Place
+ * \c .noinit in backup SRAM to keep them across power cycles as well. A magic
+ * word marks the ring as valid; anything else, as after power-on, empties it.
+ * \copyright 2025, Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sub-license, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial
+ *      portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "stm32xx_dfu_stats.h"
+
+#include "stm32xx_hal.h"     /* for HAL_GetTick */
+#include "stm32xx_startup.h" /* for NOINIT */
+
+#include <string.h> /* for memcpy, memset */
+
+/*!
+ * \brief Magic word marking a valid ring, ASCII "STAT".
+ */
+#define STATS_MAGIC 0x54415453UL
+
+/*!
+ * \brief Session ring and its book-keeping.
+ */
+static NOINIT struct {
+  uint32_t ulMagic;
+  uint32_t ulSequence;                  /*!< Sessions ever begun. */
+  DFUStats_t xRecords[DFU_STATS_COUNT]; /*!< Record n at n mod count. */
+} xStats;
+
+/*
+ * Timing state for the open session. Lost on reset, which also ends the
+ * session.
+ */
+static DFUStats_t *pxCurrent;
+static DFUPhase_t xCurrentPhase = DFU_PHASE_IDLE;
+static uint32_t ulPhaseStart;
+
+/*!
+ * \brief Empties the ring unless it carries the magic word.
+ */
+static void prvValidate(void) {
+  if (xStats.ulMagic == STATS_MAGIC)
+    return;
+  memset(&xStats, 0, sizeof(xStats));
+  xStats.ulMagic = STATS_MAGIC;
+}
+
+void vDFUStatsBegin(DFULink_t xLink) {
+  prvValidate();
+  pxCurrent = &xStats.xRecords[xStats.ulSequence & (DFU_STATS_COUNT - 1U)];
+  memset(pxCurrent, 0, sizeof(*pxCurrent));
+  pxCurrent->ulSequence = ++xStats.ulSequence;
+  pxCurrent->ucLink = (uint8_t)xLink;
+  xCurrentPhase = DFU_PHASE_IDLE;
+}
+
+void vDFUStatsPhase(DFUPhase_t xPhase) {
+  /*
+   * The next switch indexes ulPhaseMs with the phase stored here, so never
+   * store one outside the array.
+   */
+  if (xPhase < DFU_PHASE_IDLE || xPhase >= DFU_PHASE_COUNT)
+    return;
+  uint32_t ulNow = HAL_GetTick();
+  if (pxCurrent != NULL && xCurrentPhase != DFU_PHASE_IDLE)
+    pxCurrent->ulPhaseMs[xCurrentPhase] += ulNow - ulPhaseStart;
+  xCurrentPhase = xPhase;
+  ulPhaseStart = ulNow;
+}
+
+void vDFUStatsBytes(uint32_t ulBytes) {
+  if (pxCurrent != NULL)
+    pxCurrent->ulBytes += ulBytes;
+}
+
+void vDFUStatsRetry(void) {
+  if (pxCurrent != NULL && pxCurrent->usRetries != UINT16_MAX)
+    pxCurrent->usRetries++;
+}
+
+void vDFUStatsPollStall(void) {
+  if (pxCurrent != NULL && pxCurrent->usPollStalls != UINT16_MAX)
+    pxCurrent->usPollStalls++;
+}
+
+void vDFUStatsEnd(void) {
+  vDFUStatsPhase(DFU_PHASE_IDLE);
+  if (pxCurrent != NULL)
+    pxCurrent->ucComplete = 1U;
+  pxCurrent = NULL;
+}
+
+size_t xDFUStatsRead(void *pvBuffer, size_t xLength) {
+  prvValidate();
+  uint32_t ulKept = xStats.ulSequence < DFU_STATS_COUNT ? xStats.ulSequence : DFU_STATS_COUNT;
+  uint32_t ulFirst = xStats.ulSequence - ulKept;
+  size_t xCopied = 0;
+  for (uint32_t ulRecord = ulFirst; ulRecord < xStats.ulSequence; ulRecord++) {
+    if (xLength - xCopied < sizeof(DFUStats_t))
+      break;
+    memcpy((uint8_t *)pvBuffer + xCopied, &xStats.xRecords[ulRecord & (DFU_STATS_COUNT - 1U)], sizeof(DFUStats_t));
+    xCopied += sizeof(DFUStats_t);
+  }
+  return xCopied;
+}
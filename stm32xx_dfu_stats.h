@@ -0,0 +1,120 @@
+/* SPDX-License-Identifier: MIT */
+/*!
+ * \file stm32xx_dfu_stats.h
+ * \brief Per-session update telemetry kept across resets.
+ * \author Roy Ratcliffe
+ * \date 2026-10-18
+ * \copyright 2025, Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sub-license, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial
+ *      portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h> /* for size_t */
+#include <stdint.h> /* for uint32_t */
+
+/*!
+ * \brief Number of session records kept, a power of two.
+ */
+#ifndef DFU_STATS_COUNT
+#define DFU_STATS_COUNT 16U
+#endif
+
+_Static_assert((DFU_STATS_COUNT & (DFU_STATS_COUNT - 1U)) == 0U, "DFU_STATS_COUNT must be a power of two");
+
+/*!
+ * \brief Update phases timed separately.
+ */
+typedef enum {
+  DFU_PHASE_IDLE = -1, /*!< Not timing; transfer and host time. */
+  DFU_PHASE_ERASE,
+  DFU_PHASE_PROGRAM,
+  DFU_PHASE_VERIFY,
+  DFU_PHASE_MANIFEST,
+  DFU_PHASE_COUNT
+} DFUPhase_t;
+
+/*!
+ * \brief Link an update session arrived over.
+ */
+typedef enum {
+  DFU_LINK_USB,
+  DFU_LINK_UART,
+  DFU_LINK_CAN,
+  DFU_LINK_OTHER
+} DFULink_t;
+
+/*!
+ * \brief One update session, 32 bytes.
+ * \details Little-endian and packed by construction, so the host can read a
+ * bulk upload as an array of records without any decoding.
+ */
+typedef struct {
+  uint32_t ulSequence;                   /*!< Session number, from one. */
+  uint32_t ulBytes;                      /*!< Payload bytes received. */
+  uint32_t ulPhaseMs[DFU_PHASE_COUNT];   /*!< Milliseconds per phase. */
+  uint16_t usRetries;                    /*!< Blocks retried. */
+  uint16_t usPollStalls;                 /*!< GETSTATUS polls answered busy. */
+  uint8_t ucLink;                        /*!< A DFULink_t value. */
+  uint8_t ucComplete;                    /*!< Non-zero once the session ended. */
+  uint16_t usReserved;                   /*!< Zero. */
+} DFUStats_t;
+
+_Static_assert(sizeof(DFUStats_t) == 32U, "DFUStats_t is a 32-byte wire format");
+
+/*!
+ * \brief Opens a new session record, overwriting the oldest if the ring is
+ * full.
+ * \param xLink Link the session uses.
+ */
+void vDFUStatsBegin(DFULink_t xLink);
+
+/*!
+ * \brief Switches the phase being timed.
+ * \param xPhase Phase now starting, or #DFU_PHASE_IDLE to stop timing.
+ *
+ * Adds the time since the previous switch to the previous phase. Ignores
+ * any \p xPhase outside #DFU_PHASE_IDLE to #DFU_PHASE_COUNT less one, and
+ * keeps timing the current phase.
+ */
+void vDFUStatsPhase(DFUPhase_t xPhase);
+
+/*!
+ * \brief Counts payload bytes received.
+ */
+void vDFUStatsBytes(uint32_t ulBytes);
+
+/*!
+ * \brief Counts one retried block.
+ */
+void vDFUStatsRetry(void);
+
+/*!
+ * \brief Counts one GETSTATUS poll answered while busy.
+ */
+void vDFUStatsPollStall(void);
+
+/*!
+ * \brief Closes the current session record.
+ */
+void vDFUStatsEnd(void);
+
+/*!
+ * \brief Copies every kept record, oldest first, for one vendor UPLOAD.
+ * \param pvBuffer Destination.
+ * \param xLength Destination size in bytes.
+ * \returns Bytes copied, a whole number of records.
+ */
+size_t xDFUStatsRead(void *pvBuffer, size_t xLength);
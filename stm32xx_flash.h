@@ -0,0 +1,42 @@
+/* SPDX-License-Identifier: MIT */
+/*!
+ * \file stm32xx_flash.h
+ * \brief Flash sector layouts, shared by C and C++.
+ * \author Roy Ratcliffe
+ * \date 2026-10-18
+ * \copyright 2025, Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sub-license, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial
+ *      portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+/*
+ * Sector sizes in bytes, from the start of flash, as brace-free initialiser
+ * lists. The C modules and the C++ device traits both expand these, so the
+ * layouts cannot drift apart.
+ */
+
+/*!
+ * \brief STM32F405/407: four 16 KiB, one 64 KiB and seven 128 KiB sectors.
+ */
+#define STM32F407_SECTOR_SIZES                                                  \
+  0x4000UL, 0x4000UL, 0x4000UL, 0x4000UL, 0x10000UL, 0x20000UL, 0x20000UL,      \
+      0x20000UL, 0x20000UL, 0x20000UL, 0x20000UL, 0x20000UL
+
+/*!
+ * \brief STM32F411: four 16 KiB, one 64 KiB and three 128 KiB sectors.
+ */
+#define STM32F411_SECTOR_SIZES                                                  \
+  0x4000UL, 0x4000UL, 0x4000UL, 0x4000UL, 0x10000UL, 0x20000UL, 0x20000UL, 0x20000UL
@@ -0,0 +1,93 @@
+/* SPDX-License-Identifier: MIT */
+/*!
+ * \file stm32xx_irqprof.c
+ * \brief Interrupt-masked time profiler.
+ * \copyright 2025, Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sub-license, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial
+ *      portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "stm32xx_irqprof.h"
+
+#ifdef IRQPROF
+
+/*!
+ * \brief Sites that have recorded at least one window, newest first.
+ */
+static IRQProfSite_t *pxSites;
+
+/*
+ * One open window per masking mechanism. A higher-priority handler may mask
+ * with PRIMASK while a thread holds BASEPRI, so each keeps its own.
+ */
+static IRQProfSite_t *pxPRIMASKSite, *pxBASEPRISite;
+static uint32_t ulPRIMASKStart, ulBASEPRIStart;
+
+void vIRQProfInit(void) {
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0UL;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/*!
+ * \brief Adds one window of \p ulCycles to \p pxSite.
+ * \details Masks interrupts briefly itself, since a BASEPRI window leaves
+ * higher-priority handlers free to record at the same time.
+ */
+static void prvRecord(IRQProfSite_t *pxSite, uint32_t ulCycles) {
+  uint32_t ulBucket = ulCycles < 2UL ? 0UL : 31UL - __CLZ(ulCycles);
+  if (ulBucket >= IRQPROF_BUCKETS)
+    ulBucket = IRQPROF_BUCKETS - 1U;
+  uint32_t ulPRIMASK = __get_PRIMASK();
+  __disable_irq();
+  if (pxSite->ulCount++ == 0UL) {
+    pxSite->pxNext = pxSites;
+    pxSites = pxSite;
+  }
+  if (ulCycles > pxSite->ulMax)
+    pxSite->ulMax = ulCycles;
+  pxSite->ulHistogram[ulBucket]++;
+  __set_PRIMASK(ulPRIMASK);
+}
+
+void vIRQProfStartPRIMASK(IRQProfSite_t *pxSite) {
+  pxPRIMASKSite = pxSite;
+  ulPRIMASKStart = DWT->CYCCNT;
+}
+
+void vIRQProfStopPRIMASK(void) {
+  uint32_t ulCycles = DWT->CYCCNT - ulPRIMASKStart;
+  if (pxPRIMASKSite != NULL)
+    prvRecord(pxPRIMASKSite, ulCycles);
+  pxPRIMASKSite = NULL;
+}
+
+void vIRQProfStartBASEPRI(IRQProfSite_t *pxSite) {
+  pxBASEPRISite = pxSite;
+  ulBASEPRIStart = DWT->CYCCNT;
+}
+
+void vIRQProfStopBASEPRI(void) {
+  uint32_t ulCycles = DWT->CYCCNT - ulBASEPRIStart;
+  if (pxBASEPRISite != NULL)
+    prvRecord(pxBASEPRISite, ulCycles);
+  pxBASEPRISite = NULL;
+}
+
+void vIRQProfForEach(void (*pvVisit)(const IRQProfSite_t *pxSite)) {
+  for (const IRQProfSite_t *pxSite = pxSites; pxSite != NULL; pxSite = pxSite->pxNext)
+    pvVisit(pxSite);
+}
+
+#endif
@@ -0,0 +1,175 @@
+/* SPDX-License-Identifier: MIT */
+/*!
+ * \file stm32xx_irqprof.h
+ * \brief Interrupt-masked time profiler.
+ * \details Wraps the interrupt masking idioms: plain \c __disable_irq() and
+ * \c __enable_irq(), \c PRIMASK save and restore, and \c BASEPRI raise and
+ * restore. With \c IRQPROF defined, each outermost masked window is timed
+ * with the DWT cycle counter. Its length goes to the call site that opened
+ * it, as a count, a maximum and a power-of-two histogram. Without \c IRQPROF
+ * the macros expand to the bare CMSIS calls and the profiler compiles away to
+ * nothing.
+ * \author Roy Ratcliffe
+ * \date 2026-10-18
+ * \copyright 2025, Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sub-license, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial
+ *      portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "stm32xx_hal.h" /* for HAL functions and definitions */
+
+#include <stddef.h> /* for NULL */
+#include <stdint.h> /* for uint32_t */
+
+/*!
+ * \brief Histogram buckets. Bucket \c n counts windows of fewer than
+ * \c 2^(n+1) cycles; the last bucket takes everything longer.
+ */
+#ifndef IRQPROF_BUCKETS
+#define IRQPROF_BUCKETS 20U
+#endif
+
+/*!
+ * \brief Statistics for one call site that masks interrupts.
+ */
+typedef struct IRQProfSite {
+  const char *pcFile;                      /*!< Source file of the site. */
+  uint32_t ulLine;                         /*!< Source line of the site. */
+  uint32_t ulCount;                        /*!< Windows recorded. */
+  uint32_t ulMax;                          /*!< Longest window in cycles. */
+  uint32_t ulHistogram[IRQPROF_BUCKETS];   /*!< Windows by length. */
+  struct IRQProfSite *pxNext;              /*!< Next site seen. */
+} IRQProfSite_t;
+
+#ifdef IRQPROF
+
+/*!
+ * \brief Starts the DWT cycle counter. Call once at start-up.
+ */
+void vIRQProfInit(void);
+
+/*!
+ * \brief Calls \p pvVisit for every site that has recorded a window.
+ * \details Use it to dump the results, for example over a debug UART or a
+ * vendor UPLOAD, for a host-side report.
+ */
+void vIRQProfForEach(void (*pvVisit)(const IRQProfSite_t *pxSite));
+
+/*
+ * Implementation hooks for the macros below.
+ */
+void vIRQProfStartPRIMASK(IRQProfSite_t *pxSite);
+void vIRQProfStopPRIMASK(void);
+void vIRQProfStartBASEPRI(IRQProfSite_t *pxSite);
+void vIRQProfStopBASEPRI(void);
+
+/*!
+ * \brief One statically allocated site record per expansion.
+ */
+#define IRQPROF_SITE()                                                               \
+  __extension__({                                                                    \
+    static IRQProfSite_t xIRQProfSite = {__FILE__, __LINE__, 0UL, 0UL, {0UL}, NULL}; \
+    &xIRQProfSite;                                                                   \
+  })
+
+/*!
+ * \brief Profiled \c __disable_irq().
+ */
+#define IRQPROF_DISABLE_IRQ()                                                   \
+  do {                                                                          \
+    uint32_t ulIRQProfWasMasked = __get_PRIMASK();                              \
+    __disable_irq();                                                            \
+    if (ulIRQProfWasMasked == 0UL)                                              \
+      vIRQProfStartPRIMASK(IRQPROF_SITE());                                     \
+  } while (0)
+
+/*!
+ * \brief Profiled \c __enable_irq().
+ */
+#define IRQPROF_ENABLE_IRQ()                                                    \
+  do {                                                                          \
+    vIRQProfStopPRIMASK();                                                      \
+    __enable_irq();                                                             \
+  } while (0)
+
+/*!
+ * \brief Profiled \c PRIMASK save and disable.
+ * \returns Previous \c PRIMASK for IRQPROF_EXIT_CRITICAL().
+ */
+#define IRQPROF_ENTER_CRITICAL()                                                \
+  __extension__({                                                               \
+    uint32_t ulIRQProfPRIMASK = __get_PRIMASK();                                \
+    __disable_irq();                                                            \
+    if (ulIRQProfPRIMASK == 0UL)                                                \
+      vIRQProfStartPRIMASK(IRQPROF_SITE());                                     \
+    ulIRQProfPRIMASK;                                                           \
+  })
+
+/*!
+ * \brief Profiled \c PRIMASK restore.
+ */
+#define IRQPROF_EXIT_CRITICAL(_primask_)                                        \
+  do {                                                                          \
+    if ((_primask_) == 0UL)                                                     \
+      vIRQProfStopPRIMASK();                                                    \
+    __set_PRIMASK(_primask_);                                                   \
+  } while (0)
+
+/*!
+ * \brief Profiled \c BASEPRI raise.
+ * \returns Previous \c BASEPRI for IRQPROF_RESTORE_BASEPRI().
+ */
+#define IRQPROF_RAISE_BASEPRI(_basepri_)                                        \
+  __extension__({                                                               \
+    uint32_t ulIRQProfBASEPRI = __get_BASEPRI();                                \
+    __set_BASEPRI_MAX(_basepri_);                                               \
+    if (ulIRQProfBASEPRI == 0UL)                                                \
+      vIRQProfStartBASEPRI(IRQPROF_SITE());                                     \
+    ulIRQProfBASEPRI;                                                           \
+  })
+
+/*!
+ * \brief Profiled \c BASEPRI restore.
+ */
+#define IRQPROF_RESTORE_BASEPRI(_basepri_)                                      \
+  do {                                                                          \
+    if ((_basepri_) == 0UL)                                                     \
+      vIRQProfStopBASEPRI();                                                    \
+    __set_BASEPRI(_basepri_);                                                   \
+  } while (0)
+
+#else
+
+#define vIRQProfInit() ((void)0)
+#define vIRQProfForEach(_visit_) ((void)(_visit_))
+#define IRQPROF_DISABLE_IRQ() __disable_irq()
+#define IRQPROF_ENABLE_IRQ() __enable_irq()
+#define IRQPROF_ENTER_CRITICAL()                                                \
+  __extension__({                                                               \
+    uint32_t ulIRQProfPRIMASK = __get_PRIMASK();                                \
+    __disable_irq();                                                            \
+    ulIRQProfPRIMASK;                                                           \
+  })
+#define IRQPROF_EXIT_CRITICAL(_primask_) __set_PRIMASK(_primask_)
+#define IRQPROF_RAISE_BASEPRI(_basepri_)                                        \
+  __extension__({                                                               \
+    uint32_t ulIRQProfBASEPRI = __get_BASEPRI();                                \
+    __set_BASEPRI_MAX(_basepri_);                                               \
+    ulIRQProfBASEPRI;                                                           \
+  })
+#define IRQPROF_RESTORE_BASEPRI(_basepri_) __set_BASEPRI(_basepri_)
+
+#endif
@@ -0,0 +1,92 @@
+/* SPDX-License-Identifier: MIT */
+/*!
+ * \file stm32xx_merkle.c
+ * \brief Merkle tree of flash sector hashes for fast difference discovery.
+ * \details Leaves are the CRC-32 of each sector's contents. Inner nodes are
+ * the CRC-32 of their two children's hashes. CRC-32 detects change, which is
+ * all difference discovery needs. It is not a defence against deliberate
+ * collisions; authenticate images separately.
+ * \copyright 2025, Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sub-license, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial
+ *      portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "stm32xx_merkle.h"
+
+#include "stm32xx_crc.h"   /* for ulCRC32 */
+#include "stm32xx_flash.h" /* for STM32F407_SECTOR_SIZES */
+#include "stm32xx_hal.h"   /* for FLASH_BASE */
+
+/*
+ * Flash sector sizes of the selected device.
+ */
+#if defined(STM32F407xx)
+static const uint32_t ulSectorSizes[] = {STM32F407_SECTOR_SIZES};
+#elif defined(STM32F411xE)
+static const uint32_t ulSectorSizes[] = {STM32F411_SECTOR_SIZES};
+#else
+#error "No flash sector layout for the selected STM32xx device"
+#endif
+
+#define SECTOR_COUNT (sizeof(ulSectorSizes) / sizeof(ulSectorSizes[0]))
+
+_Static_assert(SECTOR_COUNT <= MERKLE_LEAVES, "MERKLE_LEAVES too small for the flash sectors");
+
+uint32_t ulMerkleTree[2U * MERKLE_LEAVES];
+
+/*!
+ * \brief Hashes one sector into its leaf.
+ */
+static void prvHashSector(uint32_t ulSector) {
+  uint32_t ulAddress = FLASH_BASE;
+  for (uint32_t ulIndex = 0; ulIndex < ulSector; ulIndex++)
+    ulAddress += ulSectorSizes[ulIndex];
+  ulMerkleTree[MERKLE_LEAVES + ulSector] = ulCRC32((const void *)ulAddress, ulSectorSizes[ulSector]);
+}
+
+/*!
+ * \brief Recomputes an inner node from its children.
+ */
+static void prvHashNode(uint32_t ulNode) {
+  ulMerkleTree[ulNode] = ulCRC32(&ulMerkleTree[2U * ulNode], 2U * sizeof(uint32_t));
+}
+
+void vMerkleInit(void) {
+  for (uint32_t ulSector = 0; ulSector < MERKLE_LEAVES; ulSector++)
+    if (ulSector < SECTOR_COUNT)
+      prvHashSector(ulSector);
+    else
+      ulMerkleTree[MERKLE_LEAVES + ulSector] = 0UL;
+  for (uint32_t ulNode = MERKLE_LEAVES - 1U; ulNode >= MERKLE_ROOT; ulNode--)
+    prvHashNode(ulNode);
+}
+
+void vMerkleSectorUpdated(uint32_t ulSector) {
+  if (ulSector >= SECTOR_COUNT)
+    return;
+  prvHashSector(ulSector);
+  for (uint32_t ulNode = (MERKLE_LEAVES + ulSector) / 2U; ulNode >= MERKLE_ROOT; ulNode /= 2U)
+    prvHashNode(ulNode);
+}
+
+size_t xMerkleQuery(uint32_t ulNode, uint32_t pulHashes[3]) {
+  if (ulNode < MERKLE_ROOT || ulNode >= 2U * MERKLE_LEAVES)
+    return 0U;
+  pulHashes[0] = ulMerkleTree[ulNode];
+  if (ulNode >= MERKLE_LEAVES)
+    return 1U;
+  pulHashes[1] = ulMerkleTree[2U * ulNode];
+  pulHashes[2] = ulMerkleTree[2U * ulNode + 1U];
+  return 3U;
+}
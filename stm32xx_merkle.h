@@ -0,0 +1,79 @@
+/* SPDX-License-Identifier: MIT */
+/*!
+ * \file stm32xx_merkle.h
+ * \brief Merkle tree of flash sector hashes for fast difference discovery.
+ * \author Roy Ratcliffe
+ * \date 2026-10-18
+ * \copyright 2025, Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sub-license, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial
+ *      portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h> /* for size_t */
+#include <stdint.h> /* for uint32_t */
+
+/*!
+ * \brief Leaves in the tree: the flash sector count rounded up to a power of
+ * two.
+ */
+#define MERKLE_LEAVES 16U
+
+/*!
+ * \brief Node index of the root.
+ * \details Nodes number in heap order: node \c n has children \c 2n and
+ * \c 2n+1, and sector \c s is leaf node \c MERKLE_LEAVES+s.
+ */
+#define MERKLE_ROOT 1U
+
+/*!
+ * \brief Hashes every flash sector and builds the tree.
+ *
+ * Expensive: it runs ulCRC32() over the whole of flash, 1 MiB on an
+ * STM32F407, which takes tens of milliseconds even with the sliced table and
+ * longer with a byte-wise one. Prefer restoring the tree instead: save
+ * ulMerkleTree with the image metadata when an update finishes, copy it back
+ * at start-up, and call vMerkleInit() only when no saved tree exists or it
+ * no longer matches the image.
+ */
+void vMerkleInit(void);
+
+/*!
+ * \brief Rehashes one sector and the path from its leaf to the root.
+ * \param ulSector Sector just erased or programmed.
+ *
+ * Costs one pass over the sector plus one small hash per tree level.
+ */
+void vMerkleSectorUpdated(uint32_t ulSector);
+
+/*!
+ * \brief Answers a node query.
+ * \param ulNode Node index, from #MERKLE_ROOT.
+ * \param pulHashes Receives the node's hash followed by its children's
+ * hashes, if it has children.
+ * \returns Number of hashes written: three for an inner node, one for a leaf,
+ * zero for an index out of range.
+ *
+ * One query returns both children, so the host descends one level per round
+ * trip. It finds each changed sector in log2(#MERKLE_LEAVES) small requests
+ * and never reads flash back.
+ */
+size_t xMerkleQuery(uint32_t ulNode, uint32_t pulHashes[3]);
+
+/*!
+ * \brief The whole tree, for saving with the image metadata.
+ * \details Heap ordered; entry zero is unused.
+ */
+extern uint32_t ulMerkleTree[2U * MERKLE_LEAVES];
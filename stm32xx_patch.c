@@ -0,0 +1,78 @@
+/* SPDX-License-Identifier: MIT */
+/*!
+ * \file stm32xx_patch.c
+ * \brief Live function hot-patching through a RAM indirection table.
+ * \copyright 2025, Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sub-license, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial
+ *      portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "stm32xx_patch.h"
+
+#include "stm32xx_hal.h"     /* for HAL functions and definitions */
+#include "stm32xx_irqprof.h" /* for IRQPROF_ENTER_CRITICAL */
+
+PatchSlot_t *volatile pxPatchTable;
+
+static const PatchFunction_t *pxDefaultTable;
+
+static size_t xTableLength;
+
+void vPatchInit(PatchSlot_t *pxTable, const PatchFunction_t *pxDefaults, size_t xLength) {
+  for (size_t xIndex = 0; xIndex < xLength; xIndex++)
+    pxTable[xIndex] = pxDefaults[xIndex];
+  pxDefaultTable = pxDefaults;
+  xTableLength = xLength;
+  pxPatchTable = pxTable;
+}
+
+int xPatchApply(const PatchBundle_t *pxBundle) {
+  if (pxBundle->ulMagic != PATCH_BUNDLE_MAGIC || pxPatchTable == NULL)
+    return -1;
+
+  /*
+   * Validate the whole bundle before touching the table.
+   * Every replacement must land inside the table and must be a Thumb address;
+   * branching to an even address on Cortex-M raises a usage fault.
+   */
+  for (uint32_t ulEntry = 0; ulEntry < pxBundle->ulCount; ulEntry++) {
+    const PatchEntry_t *pxEntry = &pxBundle->xEntries[ulEntry];
+    if (pxEntry->ulIndex >= xTableLength || ((uint32_t)pxEntry->pxFunction & 1UL) == 0UL)
+      return -1;
+  }
+
+  /*
+   * Mask interrupts while rewriting the slots.
+   * Saving and restoring PRIMASK, rather than unconditionally re-enabling,
+   * makes the call safe from code that already runs with interrupts masked.
+   * The barriers make the new slots and the new code visible before any
+   * interrupt handler can call through the table.
+   */
+  uint32_t ulPRIMASK = IRQPROF_ENTER_CRITICAL();
+  for (uint32_t ulEntry = 0; ulEntry < pxBundle->ulCount; ulEntry++)
+    pxPatchTable[pxBundle->xEntries[ulEntry].ulIndex] = pxBundle->xEntries[ulEntry].pxFunction;
+  __DSB();
+  __ISB();
+  IRQPROF_EXIT_CRITICAL(ulPRIMASK);
+  return 0;
+}
+
+void vPatchRevert(void) {
+  uint32_t ulPRIMASK = IRQPROF_ENTER_CRITICAL();
+  for (size_t xIndex = 0; xIndex < xTableLength; xIndex++)
+    pxPatchTable[xIndex] = pxDefaultTable[xIndex];
+  __DSB();
+  __ISB();
+  IRQPROF_EXIT_CRITICAL(ulPRIMASK);
+}
@@ -0,0 +1,116 @@
+/* SPDX-License-Identifier: MIT */
+/*!
+ * \file stm32xx_patch.h
+ * \brief Live function hot-patching through a RAM indirection table.
+ * \author Roy Ratcliffe
+ * \date 2026-10-18
+ * \copyright 2025, Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sub-license, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial
+ *      portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h> /* for size_t */
+#include <stdint.h> /* for uint32_t */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!
+ * \brief Generic patchable function pointer.
+ * \details Callers cast each slot back to the function's real type at the call
+ * site; see PATCH_CALL().
+ */
+typedef void (*PatchFunction_t)(void);
+
+/*!
+ * \brief One slot of the indirection table.
+ * \details Volatile, so every PATCH_CALL() loads the slot afresh. A caller
+ * cannot keep a cached pointer across an xPatchApply() run from an
+ * interrupt.
+ */
+typedef void (*volatile PatchSlot_t)(void);
+
+/*!
+ * \brief Magic number identifying a patch bundle, ASCII "PTCH".
+ */
+#define PATCH_BUNDLE_MAGIC 0x48435450UL
+
+/*!
+ * \brief One replacement function.
+ */
+typedef struct {
+  uint32_t ulIndex;            /*!< Slot in the indirection table. */
+  PatchFunction_t pxFunction;  /*!< Replacement, a Thumb address in RAM. */
+} PatchEntry_t;
+
+/*!
+ * \brief Bundle of replacement functions loaded into RAM.
+ * \details The bundle's code lives alongside it in RAM. The bundle header
+ * lists which table slots to redirect and where to.
+ */
+typedef struct {
+  uint32_t ulMagic;          /*!< Must equal #PATCH_BUNDLE_MAGIC. */
+  uint32_t ulCount;          /*!< Number of entries that follow. */
+  PatchEntry_t xEntries[];   /*!< Entries, one per replaced function. */
+} PatchBundle_t;
+
+/*!
+ * \brief Calls a patchable function through the indirection table.
+ * \param _index_ Slot index.
+ * \param _type_ Function pointer type of the slot.
+ */
+#define PATCH_CALL(_index_, _type_) ((_type_)(pxPatchTable[_index_]))
+
+/*!
+ * \brief Live indirection table, one slot per patchable function.
+ * \details Read-only to callers. Use PATCH_CALL() rather than indexing it
+ * directly.
+ */
+extern PatchSlot_t *volatile pxPatchTable;
+
+/*!
+ * \brief Initialises the indirection table from its flash-resident defaults.
+ * \param pxTable RAM table with at least \p xLength slots.
+ * \param pxDefaults Original functions, normally a \c const array in flash.
+ * \param xLength Number of slots.
+ *
+ * Call once at start-up before any PATCH_CALL(). Patches last until the next
+ * reset or the next call to vPatchRevert().
+ */
+void vPatchInit(PatchSlot_t *pxTable, const PatchFunction_t *pxDefaults, size_t xLength);
+
+/*!
+ * \brief Applies a patch bundle atomically.
+ * \param pxBundle Bundle to apply.
+ * \returns 0 on success, or -1 if the bundle is malformed. A malformed bundle
+ * changes nothing.
+ *
+ * Validates every entry first: the magic number, the slot index range and the
+ * Thumb bit of each replacement. Then it masks interrupts, rewrites the slots
+ * and restores the previous interrupt mask, so no caller ever sees a bundle
+ * half applied. The masked window lasts only as long as the slot writes.
+ */
+int xPatchApply(const PatchBundle_t *pxBundle);
+
+/*!
+ * \brief Restores every slot to its flash-resident default.
+ */
+void vPatchRevert(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,119 @@
+/* SPDX-License-Identifier: MIT */
+/*!
+ * \file stm32xx_pool.c
+ * \brief Static fixed-block pool allocator for the update pipeline.
+ * \details Each class keeps a 32-bit free map, one bit per block. Allocation
+ * claims the lowest set bit and freeing sets it again, both with an
+ * exclusive load and store loop. There is no free list to corrupt and no ABA
+ * hazard, and an interrupt that pre-empts the loop simply makes the store
+ * fail and retry.
+ * \copyright 2025, Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sub-license, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial
+ *      portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "stm32xx_pool.h"
+
+#include "stm32xx_hal.h" /* for HAL functions and definitions */
+
+/*!
+ * \brief Free map with one bit set for each of \p _count_ blocks.
+ */
+#define FREE_MAP(_count_) ((_count_) == 32U ? 0xffffffffUL : (1UL << (_count_)) - 1UL)
+
+/*!
+ * \brief Book-keeping for one block class.
+ */
+typedef struct {
+  uint32_t ulBlockSize;        /*!< Bytes per block. */
+  uint32_t ulBlockCount;       /*!< Blocks in the class. */
+  uint8_t *pucStorage;         /*!< First block. */
+  volatile uint32_t ulFree;    /*!< Set bit for each free block. */
+  volatile uint32_t ulHighWater; /*!< Most blocks in use at once. */
+} PoolClass_t;
+
+/*
+ * One static storage array per class.
+ */
+#define POOL_CLASS(_size_, _count_)                                            \
+  _Static_assert(((_size_) & 3U) == 0U, "pool block size must be a multiple of four"); \
+  _Static_assert((_count_) >= 1U && (_count_) <= 32U, "pool class holds 1 to 32 blocks"); \
+  static uint32_t ulStorage##_size_##_##_count_[(_size_) / 4U * (_count_)];
+POOL_CLASSES
+#undef POOL_CLASS
+
+static PoolClass_t xClasses[POOL_CLASS_COUNT] = {
+#define POOL_CLASS(_size_, _count_)                                            \
+  {(_size_), (_count_), (uint8_t *)ulStorage##_size_##_##_count_, FREE_MAP(_count_), 0UL},
+    POOL_CLASSES
+#undef POOL_CLASS
+};
+
+/*!
+ * \brief Raises a class's high-water mark to at least \p ulInUse.
+ */
+static void prvHighWater(PoolClass_t *pxClass, uint32_t ulInUse) {
+  uint32_t ulHighWater;
+  do {
+    ulHighWater = __LDREXW(&pxClass->ulHighWater);
+    if (ulInUse <= ulHighWater) {
+      __CLREX();
+      return;
+    }
+  } while (__STREXW(ulInUse, &pxClass->ulHighWater));
+}
+
+void *pvPoolAlloc(size_t xSize) {
+  for (PoolClass_t *pxClass = xClasses; pxClass < xClasses + POOL_CLASS_COUNT; pxClass++) {
+    if (xSize > pxClass->ulBlockSize)
+      continue;
+    uint32_t ulFree, ulBlock;
+    do {
+      ulFree = __LDREXW(&pxClass->ulFree);
+      if (ulFree == 0UL) {
+        __CLREX();
+        break;
+      }
+      /*
+       * Count trailing zeros: RBIT and CLZ on Cortex-M3 and above.
+       */
+      ulBlock = (uint32_t)__builtin_ctz(ulFree);
+    } while (__STREXW(ulFree & ~(1UL << ulBlock), &pxClass->ulFree));
+    if (ulFree == 0UL)
+      continue;
+    prvHighWater(pxClass, pxClass->ulBlockCount - (uint32_t)__builtin_popcount(ulFree) + 1UL);
+    return pxClass->pucStorage + ulBlock * pxClass->ulBlockSize;
+  }
+  return NULL;
+}
+
+void vPoolFree(void *pv) {
+  if (pv == NULL)
+    return;
+  for (PoolClass_t *pxClass = xClasses; pxClass < xClasses + POOL_CLASS_COUNT; pxClass++) {
+    uint32_t ulOffset = (uint32_t)((uintptr_t)pv - (uintptr_t)pxClass->pucStorage);
+    if (ulOffset >= pxClass->ulBlockSize * pxClass->ulBlockCount)
+      continue;
+    uint32_t ulBit = 1UL << (ulOffset / pxClass->ulBlockSize);
+    uint32_t ulFree;
+    do
+      ulFree = __LDREXW(&pxClass->ulFree);
+    while (__STREXW(ulFree | ulBit, &pxClass->ulFree));
+    return;
+  }
+}
+
+uint32_t ulPoolHighWater(size_t xClass) {
+  return xClass < POOL_CLASS_COUNT ? xClasses[xClass].ulHighWater : 0UL;
+}
@@ -0,0 +1,78 @@
+/* SPDX-License-Identifier: MIT */
+/*!
+ * \file stm32xx_pool.h
+ * \brief Static fixed-block pool allocator for the update pipeline.
+ * \author Roy Ratcliffe
+ * \date 2026-10-18
+ * \copyright 2025, Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sub-license, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial
+ *      portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h> /* for size_t */
+#include <stdint.h> /* for uint32_t */
+
+/*!
+ * \brief Block classes as a list of \c POOL_CLASS(size,count) entries.
+ * \details Sizes in bytes, ascending, each a multiple of four. At most 32
+ * blocks per class. Override in the project settings to suit the pipeline:
+ * small blocks for control records, larger ones for receive, decrypt and
+ * decompress windows, and the largest for a flash program unit.
+ */
+#ifndef POOL_CLASSES
+#define POOL_CLASSES                                                           \
+  POOL_CLASS(64U, 16U)                                                         \
+  POOL_CLASS(512U, 8U)                                                         \
+  POOL_CLASS(2048U, 4U)
+#endif
+
+/*!
+ * \brief Number of block classes.
+ */
+enum {
+#define POOL_CLASS(_size_, _count_) +1
+  POOL_CLASS_COUNT = 0 POOL_CLASSES
+#undef POOL_CLASS
+};
+
+/*!
+ * \brief Allocates a block of at least \p xSize bytes.
+ * \param xSize Bytes required.
+ * \returns Word-aligned block, or \c NULL if no class large enough has a free
+ * block.
+ *
+ * Tries the smallest class that fits, then each larger class in turn. Each
+ * attempt is a bit scan and one exclusive store, so the cost is bounded by the
+ * number of classes. Lock-free and safe to call from interrupt handlers.
+ */
+void *pvPoolAlloc(size_t xSize);
+
+/*!
+ * \brief Returns a block to its class.
+ * \param pv Block from pvPoolAlloc(), or \c NULL which does nothing.
+ *
+ * Lock-free and safe to call from interrupt handlers.
+ */
+void vPoolFree(void *pv);
+
+/*!
+ * \brief Most blocks ever in use at once for a class.
+ * \param xClass Class index, from zero in the order of #POOL_CLASSES.
+ * \returns High-water mark in blocks.
+ *
+ * Use it to size #POOL_CLASSES from real update runs.
+ */
+uint32_t ulPoolHighWater(size_t xClass);
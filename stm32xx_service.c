@@ -0,0 +1,45 @@
+/* SPDX-License-Identifier: MIT */
+/*!
+ * \file stm32xx_service.c
+ * \brief Service table exported by the loader.
+ * \details Link this file into the loader only. The application includes
+ * stm32xx_service.h and calls through pxServiceTable() instead of linking its
+ * own copies of the services.
+ * \copyright 2025, Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sub-license, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial
+ *      portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "stm32xx_service.h"
+
+#include "stm32xx_dfu.h" /* for vJumpToDFU, vJumpToImage */
+
+/*!
+ * \brief The loader's service table.
+ * \details The loader's linker script must place \c .service_table at
+ * #SERVICE_TABLE_ADDRESS and keep it, for example:
+ * \code
+ * .service_table 0x08000200 : { KEEP(*(.service_table)) } >FLASH
+ * \endcode
+ */
+__attribute__((section(".service_table"), used)) const ServiceTable_t xServiceTable = {
+    .ulMagic = SERVICE_TABLE_MAGIC,
+    .usMajor = SERVICE_TABLE_MAJOR,
+    .usMinor = SERVICE_TABLE_MINOR,
+    .ulSize = sizeof(ServiceTable_t),
+    .vJumpToDFU = vJumpToDFU,
+    .vJumpToImage = vJumpToImage,
+    .ulCRC32Update = ulCRC32Update,
+    .ulCRC32STM32Update = ulCRC32STM32Update,
+};
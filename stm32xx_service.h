@@ -0,0 +1,122 @@
+/* SPDX-License-Identifier: MIT */
+/*!
+ * \file stm32xx_service.h
+ * \brief Versioned service table shared between loader and application.
+ * \author Roy Ratcliffe
+ * \date 2026-10-18
+ * \copyright 2025, Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sub-license, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial
+ *      portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "stm32xx_crc.h"   /* for ulCRC32Update */
+
+#include <stddef.h> /* for offsetof */
+#include <stdint.h> /* for uint32_t */
+
+/*!
+ * \brief Fixed address of the loader's service table.
+ * \details The loader's linker script places the \c .service_table section
+ * here. The default sits just after a 512-byte STM32F4 vector table at the
+ * start of flash. Override it in the project settings if the loader differs.
+ */
+#ifndef SERVICE_TABLE_ADDRESS
+#define SERVICE_TABLE_ADDRESS 0x08000200UL
+#endif
+
+/*!
+ * \brief Magic number identifying the service table, ASCII "SERV".
+ */
+#define SERVICE_TABLE_MAGIC 0x56524553UL
+
+/*!
+ * \brief Major version. Changes whenever an existing slot moves or changes
+ * type. The application refuses a table with a different major version.
+ */
+#define SERVICE_TABLE_MAJOR 2U
+
+/*!
+ * \brief Minor version. Changes whenever slots are appended. The application
+ * accepts any minor version at least as new as its own.
+ */
+#define SERVICE_TABLE_MINOR 0U
+
+/*!
+ * \brief Service table exported by the loader.
+ * \details Much like the MSP and PC pair that vJumpToDFU() consumes from the
+ * start of a vector table, the application finds this table at a fixed
+ * address and calls through its function pointers. New services are only
+ * ever appended, so older applications keep working with newer loaders.
+ *
+ * Only services that keep no static state belong here. Once the application
+ * runs, the loader's RAM is the application's, so a service that keeps
+ * static state in the loader's image would read and write the application's
+ * variables. The jumps keep everything in registers, on the caller's stack or
+ * on the new main stack, debug snapshot included; the CRC functions use only
+ * constant tables.
+ */
+typedef struct {
+  uint32_t ulMagic;  /*!< Must equal #SERVICE_TABLE_MAGIC. */
+  uint16_t usMajor;  /*!< #SERVICE_TABLE_MAJOR at loader build time. */
+  uint16_t usMinor;  /*!< #SERVICE_TABLE_MINOR at loader build time. */
+  uint32_t ulSize;   /*!< Size of the table in bytes. */
+  void (*vJumpToDFU)(const uint32_t *pulMSP_PC);
+  void (*vJumpToImage)(const uint32_t *pulVectors);
+  uint32_t (*ulCRC32Update)(uint32_t ulCRC, const void *pvData, size_t xLength);
+  uint32_t (*ulCRC32STM32Update)(uint32_t ulCRC, const uint32_t *pulData, size_t xWords);
+} ServiceTable_t;
+
+/*
+ * Compile-time ABI checks. Both sides build against this header. The offsets
+ * below describe major version 2 and appended slots only; the first assert
+ * ties them to the version, so moving a slot means editing the offsets and
+ * the major version together.
+ */
+_Static_assert(SERVICE_TABLE_MAJOR == 2U, "service table offsets below are for major version 2");
+_Static_assert(sizeof(void (*)(void)) == 4U, "service table assumes 32-bit pointers");
+_Static_assert(offsetof(ServiceTable_t, ulMagic) == 0U, "service table ABI");
+_Static_assert(offsetof(ServiceTable_t, usMajor) == 4U, "service table ABI");
+_Static_assert(offsetof(ServiceTable_t, usMinor) == 6U, "service table ABI");
+_Static_assert(offsetof(ServiceTable_t, ulSize) == 8U, "service table ABI");
+_Static_assert(offsetof(ServiceTable_t, vJumpToDFU) == 12U, "service table ABI");
+_Static_assert(offsetof(ServiceTable_t, vJumpToImage) == 16U, "service table ABI");
+_Static_assert(offsetof(ServiceTable_t, ulCRC32Update) == 20U, "service table ABI");
+_Static_assert(offsetof(ServiceTable_t, ulCRC32STM32Update) == 24U, "service table ABI");
+_Static_assert(sizeof(ServiceTable_t) == 28U, "service table ABI");
+
+/*!
+ * \brief Finds the loader's service table.
+ * \returns Pointer to the table, or \c NULL if there is no table at
+ * #SERVICE_TABLE_ADDRESS or its version is incompatible.
+ *
+ * Check the result once at start-up and keep the pointer. Each service call
+ * then costs one load and an indirect branch.
+ *
+ * The minor version check rejects a loader older than the application's
+ * header; the size check also guards against a truncated table. At minor
+ * version zero every table passes the former, so the preprocessor drops it.
+ */
+static inline const ServiceTable_t *pxServiceTable(void) {
+  const ServiceTable_t *pxTable = (const ServiceTable_t *)SERVICE_TABLE_ADDRESS;
+  if (pxTable->ulMagic != SERVICE_TABLE_MAGIC || pxTable->usMajor != SERVICE_TABLE_MAJOR ||
+      pxTable->ulSize < sizeof(ServiceTable_t))
+    return NULL;
+#if SERVICE_TABLE_MINOR > 0U
+  if (pxTable->usMinor < SERVICE_TABLE_MINOR)
+    return NULL;
+#endif
+  return pxTable;
+}
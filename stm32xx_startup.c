@@ -0,0 +1,90 @@
+/* SPDX-License-Identifier: MIT */
+/*!
+ * \file stm32xx_startup.c
+ * \brief Fast section initialisation for STM32 start-up.
+ * \copyright 2025, Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sub-license, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial
+ *      portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "stm32xx_startup.h"
+
+#include <stdint.h> /* for uint32_t */
+
+/*!
+ * \brief Stops the compiler turning the loops below into library calls.
+ * \details Section initialisation runs before static storage exists. GCC and
+ * Clang would otherwise recognise the copy and fill loops and call \c memcpy
+ * or \c memset, which may themselves rely on initialised data. An empty
+ * assembler statement that clobbers memory, once per iteration, hides the
+ * idiom from both compilers without per-function optimisation attributes or
+ * special build flags for this file.
+ */
+#define NO_LIBCALLS() __asm__ volatile("" ::: "memory")
+
+/*
+ * Linker-script symbols. Only their addresses matter.
+ */
+extern uint32_t _sidata[], _sdata[], _edata[], _sbss[], _ebss[];
+extern uint32_t _slazy_bss[], _elazy_bss[];
+
+/*!
+ * \brief Copies words from one region to another, four at a time.
+ * \details Four independent loads followed by four stores let the compiler
+ * emit \c LDM and \c STM bursts, which is markedly faster than a byte or
+ * single-word loop on flash with wait states.
+ */
+static void prvCopyWords(uint32_t *pulTo, const uint32_t *pulFrom, const uint32_t *pulEnd) {
+  while (pulEnd - pulTo >= 4) {
+    uint32_t ul0 = pulFrom[0], ul1 = pulFrom[1], ul2 = pulFrom[2], ul3 = pulFrom[3];
+    pulTo[0] = ul0;
+    pulTo[1] = ul1;
+    pulTo[2] = ul2;
+    pulTo[3] = ul3;
+    pulTo += 4;
+    pulFrom += 4;
+    NO_LIBCALLS();
+  }
+  while (pulTo < pulEnd) {
+    *pulTo++ = *pulFrom++;
+    NO_LIBCALLS();
+  }
+}
+
+/*!
+ * \brief Zeroes words, four at a time.
+ */
+static void prvZeroWords(uint32_t *pulTo, const uint32_t *pulEnd) {
+  while (pulEnd - pulTo >= 4) {
+    pulTo[0] = 0UL;
+    pulTo[1] = 0UL;
+    pulTo[2] = 0UL;
+    pulTo[3] = 0UL;
+    pulTo += 4;
+    NO_LIBCALLS();
+  }
+  while (pulTo < pulEnd) {
+    *pulTo++ = 0UL;
+    NO_LIBCALLS();
+  }
+}
+
+void vInitSections(void) {
+  prvCopyWords(_sdata, _sidata, _edata);
+  prvZeroWords(_sbss, _ebss);
+}
+
+void vInitLazySections(void) {
+  prvZeroWords(_slazy_bss, _elazy_bss);
+}
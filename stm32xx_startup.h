@@ -0,0 +1,61 @@
+/* SPDX-License-Identifier: MIT */
+/*!
+ * \file stm32xx_startup.h
+ * \brief Fast section initialisation for STM32 start-up.
+ * \author Roy Ratcliffe
+ * \date 2026-10-18
+ * \copyright 2025, Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sub-license, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial
+ *      portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+/*!
+ * \brief Places a variable in the \c .noinit section.
+ * \details Start-up neither copies nor clears \c .noinit, so its contents
+ * survive a reset. Use it for the DFU magic word and for diagnostics that must
+ * outlive a hand-off.
+ */
+#define NOINIT __attribute__((section(".noinit")))
+
+/*!
+ * \brief Places a zero-initialised variable in the \c .lazy_bss section.
+ * \details Start-up skips \c .lazy_bss. The application must call
+ * vInitLazySections() before first use, typically once the time-critical
+ * services are running.
+ */
+#define LAZY_BSS __attribute__((section(".lazy_bss")))
+
+/*!
+ * \brief Initialises \c .data and \c .bss using word bursts.
+ *
+ * Copies \c .data from its load address in flash and zeroes \c .bss, four
+ * words per iteration with a single-word tail. Leaves \c .noinit and
+ * \c .lazy_bss untouched. Call from the reset handler in place of the usual
+ * copy and fill loops, before any C code that touches static storage.
+ *
+ * \note Relies on the linker symbols \c _sidata, \c _sdata, \c _edata,
+ * \c _sbss and \c _ebss, as in the STM32CubeIDE linker scripts, all aligned
+ * to four bytes.
+ */
+void vInitSections(void);
+
+/*!
+ * \brief Zeroes the deferred \c .lazy_bss section.
+ *
+ * \note Relies on the linker symbols \c _slazy_bss and \c _elazy_bss, aligned
+ * to four bytes.
+ */
+void vInitLazySections(void);